@@ -1,5 +1,17 @@
-#include <unordered_map>
+#pragma once
+
+#include <vector>
 #include "SegregatedFreeLists.hpp"
+#include "ExtentFreeList.hpp"
+#include "OccupancyBitmap.hpp"
+
+// 空闲空间管理引擎，两者接口相同：
+// 默认使用按地址索引的 ExtentFreeList，定义 USE_SEGREGATED_FREE_LIST 可以切换回分离空闲链表
+#ifdef USE_SEGREGATED_FREE_LIST
+using FreeSpaceManager = SegregatedFreeList;
+#else
+using FreeSpaceManager = ExtentFreeList;
+#endif
 
 class Disk {
 public:
@@ -9,22 +21,29 @@ public:
     int head_point;  // 磁头位置
     bool last_action_is_read;  // 上一次的动作是否是读
     int last_token_cost;    // 上一次的操作消耗的token数，用于计算read cost
-    // 维护一个 <tag, num> 字典，保存该磁盘上标签为 tag 的数据块数量，用于磁盘选择
+    // tag_slot_num[tag] 为该磁盘上标签为 tag 的数据块数量，用于磁盘选择，由 DiskScheduler 按标签数初始化
     // ? 可以试试保存标签为 tag 的对象数量，看看哪个好
-    std::unordered_map<int, int> tag_slot_num;
-    // 维护一个分离空闲链表，用于写操作
-    SegregatedFreeList sfl;
+    std::vector<int> tag_slot_num;
+    // 维护空闲空间，用于写操作
+    FreeSpaceManager sfl;
+    // 每个存储单元是否被占用的位图，用于按位置查找空闲区间和统计碎片
+    OccupancyBitmap occupancy;
+    // 按预测写入量划分的标签区域，标签 tag 的区域为 [tag_zone_start[tag], tag_zone_start[tag + 1])，为空表示不分区
+    std::vector<int> tag_zone_start;
+    // 反向索引：存储单元上存放的对象id（0表示空闲）和它是对象的第几块，磁头读到任意单元时可以知道读到了什么
+    std::vector<int> unit_object;
+    std::vector<unsigned char> unit_block;
 
     Disk() {
         this->id = -1;
     }
 
-    Disk(int id, int size) : sfl(size) {
+    Disk(int id, int size) : sfl(size), occupancy(size), unit_object(size + 1, 0), unit_block(size + 1, 0) {
         this->id = id;
         this->size = size;
         this->used_units = 0;
         this->head_point = 1;
         this->last_action_is_read = false;
-        int last_token_cost = 0;
+        this->last_token_cost = 0;
     }
 };
\ No newline at end of file
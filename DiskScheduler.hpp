@@ -1,86 +1,652 @@
 #include <queue>
+#include <map>
 #include <algorithm>
 #include <string>
 #include <cmath>
 #include <functional>
+#include <memory>
 
 #include "Disk.hpp"
-#include "Object.hpp"
-#include "Request.hpp"
+#include "ObjectTable.hpp"
+#include "RequestPool.hpp"
+#include "IndexedHeap.hpp"
+#include "HeadPlanner.hpp"
+#include "ThreadPool.hpp"
+#include "Telemetry.hpp"
+#include "TagHeatEstimator.hpp"
+#include "SchedulingPolicies.hpp"
+
+// 磁盘调度器，读请求优先级和写入磁盘的得分由策略类型决定（见 SchedulingPolicies.hpp），默认策略为 DiskScheduler
+template <typename PriorityPolicy = DefaultPriorityPolicy, typename DiskSelectionPolicy = DefaultDiskSelectionPolicy>
+class BasicDiskScheduler {
+public:
+    // 读调度模式
+    enum class ReadMode {
+        SINGLE_TASK,    // 每个磁头同一时间只负责一个请求，读完再接下一个
+        SWEEP           // 请求一到就分配给磁盘，磁头沿移动方向扫描（C-SCAN），读取经过的所有待读块
+    };
+
+    // 磁头经过待读块之间的间隙的方式
+    enum class HeadPolicy {
+        GREEDY,     // 总是 Pass 到下一个待读块再读
+        LOOKAHEAD   // 用 HeadPlanner 规划前方的待读块，间隙较小时连读通过，保持读的令牌数衰减
+    };
 
-class DiskScheduler {
 private:
     int numTag;   // tag数
     int numDisks;
     int G;
+    ReadMode read_mode;
+    HeadPolicy head_policy;
     std::vector<std::vector<std::vector<int>>> tag_info; // 每个标签在每个epoch中删除、写入、读取的对象块数量
     // 维护一个二维标签热度数组tag_heat[tag][epoch]，本轮和下一轮中（这个窗口可以调整）该标签读得越多越热，删得越少越热
     std::vector<std::vector<float>> tag_heat;
+    // 预测热度与实际到达的读请求、删除混合后的在线热度，写入顺序和请求优先级都用它
+    TagHeatEstimator heat_model;
     std::vector<Disk> disks;
-    std::unordered_map<int, Object> saved_objects;    // <object_id, Object>
-    std::unordered_map<int, Request> requests;    // <request_id，Request>
-    
-    using RequestQueue = std::priority_queue<int, std::vector<int>, std::function<bool(int, int)>>;
-    RequestQueue requests_queue;  // 请求的优先队列，存储请求id
-
-    // 磁盘负责的请求任务
-    struct Task {
-        int request_id = -1;  // 请求id，-1表示没有任务
-        int object_id = -1;  // 对象id
-        int disk_id = -1;     // 磁盘id
-        std::queue<int> unit_to_be_read;  // 待读取的存储块
+    ObjectTable saved_objects;    // 按对象id索引的已写入对象
+    RequestPool requests;    // 按请求id寻址的未完成请求，超时的请求只在 expired_requests 中保留id
+    // 每个对象还没完成、也没超时的请求id，读到对象块和新请求到达时只遍历这些请求
+    std::unordered_map<int, std::vector<int>> object_requests;    // <object_id, request_ids>
+    // 每个对象已经超时的请求id，只在删除对象时作为被取消的请求上报
+    std::unordered_map<int, std::vector<int>> expired_requests;    // <object_id, request_ids>
+
+    // 按到达时间片分桶的时间轮，deadline_wheel[t % (EXTRA_TIME + 1)] 为第 t 个时间片到达的请求id
+    // 每个时间片只处理到达截止时间或需要重新评分的桶，不用遍历所有请求
+    std::vector<std::vector<int>> deadline_wheel;
+    int current_timestamp = 0;
+
+    using RequestQueue = IndexedHeap<float, RequestPool::HeapPosition>;
+    RequestQueue requests_queue;  // 请求的优先队列（可按id删除），存储请求id和缓存的优先级
+
+    // 等待某个存储单元的请求，以及该单元是对象的第几块
+    struct PendingRead {
+        int req_id;
+        int block;
     };
-    std::vector<Task> working_disks;  // 有工作的磁盘，working_disks[i]表示i号磁盘负责的任务
+
+    // 磁头读到的对象块
+    struct BlockRead {
+        int object_id;
+        int block;
+    };
+
+    // 磁盘负责的读任务，待读块按存储单元位置排序，磁头扫过时读取
+    struct DiskQueue {
+        std::map<int, std::vector<PendingRead>> pending_units;  // <存储单元, 等待读取该块的请求>
+        int request_count = 0;  // 分配给该磁盘、还没完成的请求数
+        HeadPlanner planner;    // 该磁盘磁头的动作规划
+        std::vector<int> plan_offsets;  // 规划范围内待读块相对磁头的距离
+        std::vector<BlockRead> read_blocks;  // 本时间片在该磁盘上读到的、有请求在等待的块，所有磁头动作结束后再统一记到请求上
+    };
+    std::vector<DiskQueue> disk_queues;  // disk_queues[i]表示i号磁盘负责的读任务
+    // 并行移动磁头的线程池，为空时串行执行
+    std::unique_ptr<ThreadPool> read_pool;
+    std::vector<int> credit_finished;   // credit_block 中读完的请求，复用内存
+    Telemetry telemetry;    // 可选的运行统计，没有定义 ENABLE_TELEMETRY 时为空实现
+    std::vector<float> write_scores;    // 选择写入磁盘时每个磁盘的得分，复用内存
+    std::vector<int> batch_units;       // 本批已经写入每个磁盘的块数
+    int batch_total = 0;                // 本批写入的总块数（含副本）
+    std::vector<int> rejected_requests; // 被准入控制拒绝、不在请求队列中的请求id，可能包含已经不在请求池中的id
+
+    // 请求完成或被取消后，从对象的待完成请求列表中移除
+    void detach_request(int req_id, int object_id) {
+        auto it = object_requests.find(object_id);
+        if (it == object_requests.end())
+            return;
+        std::vector<int>& ids = it->second;
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (ids[i] == req_id) {
+                ids[i] = ids.back();
+                ids.pop_back();
+                break;
+            }
+        }
+        if (ids.empty())
+            object_requests.erase(it);
+    }
 
     bool have_idle_disk() {
         for (int i = 1; i <= numDisks; ++i) {
-            if (working_disks[i].request_id == -1) {
+            if (disk_queues[i].request_count == 0) {
                 return true;
             }
         }
         return false;
     }
 
+    // 请求对象在 disk_id 上的副本
+    const Replica& replica_on(int object_id, int disk_id) const {
+        for (int i = 0; i < REP_NUM; i++) {
+            if (saved_objects.replica(object_id, i).disk_id == disk_id)
+                return saved_objects.replica(object_id, i);
+        }
+        return saved_objects.replica(object_id, 0);
+    }
+
+    // 对象上已经分配给磁盘、正在读取的另一个请求，没有时返回nullptr
+    const Request* in_flight_request(int object_id, int req_id) {
+        auto it = object_requests.find(object_id);
+        if (it == object_requests.end())
+            return nullptr;
+        for (int other_id : it->second) {
+            const Request* other = requests.find(other_id);
+            if (other != nullptr && other_id != req_id && other->is_assigned())
+                return other;
+        }
+        return nullptr;
+    }
+
+    // 磁头读到 unit 时的预计代价：到该单元的距离（超过G时直接跳，最多G个令牌）+ 磁盘上已有待读块的读取代价
+    int read_arrival_cost(int disk_id, int unit) {
+        Disk& disk = disks[disk_id];
+        int distance = (unit - disk.head_point + disk.size) % disk.size;
+        return std::min(distance, G) + static_cast<int>(disk_queues[disk_id].pending_units.size()) * 16;
+    }
+
+    /*
+     * @Description: 估计 disk_id 号磁盘的磁头读到 unit 还需要的时间片数
+     * 磁头只向前扫描，到 unit 之前要经过距离内的所有单元，并读完途中的待读块；
+     * 待读块按均匀分布估计，途中的块数 = 待读块总数 × 距离 / 磁盘大小，每块按 ADMISSION_READ_TOKENS 个令牌计算
+     */
+    int estimated_slices(int disk_id, int unit) const {
+        const Disk& disk = disks[disk_id];
+        int distance = (unit - disk.head_point + disk.size) % disk.size;
+        long long pending_ahead = static_cast<long long>(disk_queues[disk_id].pending_units.size()) * distance / disk.size;
+        // 途中没有待读块时超过G的距离直接跳过去
+        long long tokens = pending_ahead == 0 ? std::min(distance, G) : distance + pending_ahead * ADMISSION_READ_TOKENS;
+        return static_cast<int>(tokens / G) + 1;
+    }
+
+    // 按 block_disk 的分配预计请求读完的时间片，晚于 deadline_timestamp 再完成也是0分
+    bool can_meet_deadline(const Request& req) const {
+        int slices = 0;
+        for (int b = 1; b <= req.object_size; b++) {
+            int disk_id = req.block_disk[b];
+            if (disk_id != 0 && !(req.read_mask >> b & 1))
+                slices = std::max(slices, estimated_slices(disk_id, replica_on(req.object_id, disk_id).units[b]));
+        }
+        return current_timestamp + slices <= req.deadline_timestamp;
+    }
+
+    /*
+     * @Description: 为请求的每一块选择负责读取的磁盘，结果写入 req.block_disk
+     * SINGLE_TASK 模式下整个对象由一个空闲磁盘读取；
+     * SWEEP 模式下每一块分别选择预计最早读到它的副本，一个大对象可以由多个磁头同时读取。
+     * 换磁盘读下一块要重新从64个令牌开始读，所以只有明显更快时才拆开
+     * @return: 没有合适的磁盘返回false
+     */
+    bool select_read_disks(Request& req) {
+        Replica* replicas = &saved_objects.replica(req.object_id, 0);
+        if (read_mode == ReadMode::SINGLE_TASK) {
+            // 简单地查看该请求对象的三个副本所在磁盘哪个是空闲的
+            for (int i = 0; i < REP_NUM; i++) {
+                if (disk_queues[replicas[i].disk_id].request_count == 0) {
+                    for (int b = 1; b <= req.object_size; b++) {
+                        if (!(req.read_mask >> b & 1))
+                            req.block_disk[b] = replicas[i].disk_id;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+        // 同一对象已经有正在读的请求时，加入它的读取：它还没读到的块沿用同一个磁盘，一次读取同时满足两个请求
+        const Request* in_flight = in_flight_request(req.object_id, req.req_id);
+        int prev = -1;  // 上一块选择的副本
+        for (int b = 1; b <= req.object_size; b++) {
+            // 排队期间已经被其他磁头顺路读到的块不用再分配
+            if (req.read_mask >> b & 1)
+                continue;
+            if (in_flight != nullptr && in_flight->block_disk[b] != 0 && !(in_flight->read_mask >> b & 1)) {
+                req.block_disk[b] = in_flight->block_disk[b];
+                for (int i = 0; i < REP_NUM; i++) {
+                    if (replicas[i].disk_id == req.block_disk[b])
+                        prev = i;
+                }
+                continue;
+            }
+            int best = -1;
+            int best_cost = 0;
+            for (int i = 0; i < REP_NUM; i++) {
+                int cost = read_arrival_cost(replicas[i].disk_id, replicas[i].units[b]);
+                if (i != prev)
+                    cost += SPLIT_READ_PENALTY;
+                if (best == -1 || cost < best_cost) {
+                    best = i;
+                    best_cost = cost;
+                }
+            }
+            req.block_disk[b] = replicas[best].disk_id;
+            prev = best;
+        }
+        return true;
+    }
+
+    // 请求涉及的不同磁盘，返回个数
+    int involved_disks(const Request& req, int disk_ids[REP_NUM]) const {
+        int n = 0;
+        for (int b = 1; b <= req.object_size; b++) {
+            int disk_id = req.block_disk[b];
+            if (disk_id != 0 && std::find(disk_ids, disk_ids + n, disk_id) == disk_ids + n)
+                disk_ids[n++] = disk_id;
+        }
+        return n;
+    }
+
+    // 把请求还没读到的每一块加入负责磁盘的待读集合
+    void assign_request(int req_id) {
+        Request& req = requests[req_id];
+        for (int b = 1; b <= req.object_size; b++) {
+            int disk_id = req.block_disk[b];
+            if (disk_id != 0)
+                disk_queues[disk_id].pending_units[replica_on(req.object_id, disk_id).units[b]].push_back({req_id, b});
+        }
+        int disk_ids[REP_NUM];
+        int n = involved_disks(req, disk_ids);
+        for (int i = 0; i < n; i++)
+            disk_queues[disk_ids[i]].request_count++;
+        req.status = Status::READING;
+    }
+
+    // 从 disk_id 号磁盘的待读集合中移除请求的第 block 块
+    void remove_pending(int disk_id, int req_id, int object_id, int block) {
+        DiskQueue& queue = disk_queues[disk_id];
+        auto it = queue.pending_units.find(replica_on(object_id, disk_id).units[block]);
+        if (it == queue.pending_units.end())
+            return;
+        std::vector<PendingRead>& reads = it->second;
+        reads.erase(std::remove_if(reads.begin(), reads.end(),
+            [req_id](const PendingRead& read) { return read.req_id == req_id; }), reads.end());
+        if (reads.empty())
+            queue.pending_units.erase(it);
+    }
+
+    // 请求被取消时，从负责磁盘的待读集合中移除还没读到的块
+    void unassign_request(int req_id) {
+        Request& req = requests[req_id];
+        for (int b = 1; b <= req.object_size; b++) {
+            int disk_id = req.block_disk[b];
+            if (disk_id != 0 && !(req.read_mask >> b & 1))
+                remove_pending(disk_id, req_id, req.object_id, b);
+        }
+        int disk_ids[REP_NUM];
+        int n = involved_disks(req, disk_ids);
+        for (int i = 0; i < n; i++)
+            disk_queues[disk_ids[i]].request_count--;
+        std::fill(req.block_disk, req.block_disk + MAX_OBJ_SIZE + 1, 0);
+    }
+
+    // 请求超过截止时间：不再读取，移出请求池，id 移到 expired_requests 中，对象被删除时照常上报取消
+    void expire_request(int req_id) {
+        Request& req = requests[req_id];
+        detach_request(req_id, req.object_id);
+        expired_requests[req.object_id].emplace_back(req_id);
+        if (req.is_assigned())
+            unassign_request(req_id);
+        for (int b = 1; b <= req.object_size; b++) {
+            if (!(req.read_mask >> b & 1))
+                saved_objects.pending_reads(req.object_id, b)--;
+        }
+        requests_queue.erase(req_id);
+        requests.erase(req_id);
+    }
+
+    void finish_request(int req_id, std::vector<int>& completed_requests) {
+        Request& req = requests[req_id];
+        completed_requests.emplace_back(req_id);
+        telemetry.on_complete(current_timestamp - req.start_timestamp);
+        int disk_ids[REP_NUM];
+        int n = involved_disks(req, disk_ids);
+        for (int i = 0; i < n; i++)
+            disk_queues[disk_ids[i]].request_count--;
+        detach_request(req_id, req.object_id);
+        // 排队期间就被顺路读完的请求还在请求队列中
+        requests_queue.erase(req_id);
+        requests.erase(req_id);
+    }
+
+    /*
+     * @Description: 把读到的对象块记到所有在等这一块的请求上，不管这一块原本分配给哪个磁盘，还在排队的请求也算
+     * 原本分配给其他磁盘的这一块从该磁盘的待读集合中移除
+     * @param disk_id: 读到这一块的磁盘
+     */
+    void credit_block(int disk_id, const BlockRead& read, std::vector<int>& completed_requests) {
+        auto it = object_requests.find(read.object_id);
+        if (it == object_requests.end())
+            return;
+        std::vector<int>& finished = credit_finished;
+        finished.clear();
+        for (int req_id : it->second) {
+            Request* req = requests.find(req_id);
+            if (req == nullptr || (req->read_mask >> read.block & 1))
+                continue;
+            req->read_mask |= 1 << read.block;
+            saved_objects.pending_reads(read.object_id, read.block)--;
+            int owner = req->block_disk[read.block];
+            if (owner != 0 && owner != disk_id)
+                remove_pending(owner, req_id, read.object_id, read.block);
+            if (req->all_blocks_read())
+                finished.emplace_back(req_id);
+        }
+        // finish_request 会修改 object_requests，所以先收集再完成
+        for (int req_id : finished) {
+            finish_request(req_id, completed_requests);
+        }
+    }
+
+    // 读取当前磁头位置的存储单元，消耗的令牌数取决于上一个动作
+    int read_cost(const Disk& disk) const {
+        return disk.last_action_is_read ? std::max(16, static_cast<int>(std::ceil(static_cast<double>(disk.last_token_cost) * 0.8))) : 64;
+    }
+
+    // 磁头最多 Pass n 次，令牌不够时尽量靠近，返回实际 Pass 的次数
+    int pass_units(Disk& disk, std::string& action, int& tokens, int n) {
+        int step = std::min(n, tokens);
+        if (step <= 0)
+            return 0;
+        action.append(step, 'p');
+        tokens -= step;
+        if (Telemetry::ENABLED)
+            telemetry.disk(disk.id).pass_tokens += step;
+        disk.head_point = (disk.head_point - 1 + step) % disk.size + 1;
+        disk.last_action_is_read = false;
+        disk.last_token_cost = 1;
+        return step;
+    }
+
+    // 读取磁头位置的存储单元，该单元上的对象块有请求在等待时（不管是否分配给本磁盘），记下这一块；令牌不够时返回false
+    // 可能在多个线程中同时对不同磁盘调用：只读 saved_objects，不修改 requests，读到的块先记在本磁盘的 read_blocks 中
+    bool read_unit(int disk_id, std::string& action, int& tokens) {
+        Disk& disk = disks[disk_id];
+        int cost_token = read_cost(disk);
+        if (tokens < cost_token)
+            return false;
+        tokens -= cost_token;
+        action += 'r';
+        if (Telemetry::ENABLED)
+            telemetry.disk(disk_id).read_tokens += cost_token;
+        int unit = disk.head_point;
+        disk.head_point = (disk.head_point % disk.size) + 1;    // 索引从1开始
+        disk.last_action_is_read = true;
+        disk.last_token_cost = cost_token;
+
+        DiskQueue& queue = disk_queues[disk_id];
+        queue.pending_units.erase(unit);
+        int object_id = disk.unit_object[unit];
+        if (object_id != 0 && saved_objects.pending_reads(object_id, disk.unit_block[unit]) > 0)
+            queue.read_blocks.push_back({object_id, disk.unit_block[unit]});
+        return true;
+    }
+
+    /*
+     * @Description: 按 HeadPlanner 的规划移动磁头，规划范围是前方 LOOKAHEAD_SLICES 个时间片内能到达的待读块
+     * @return: 规划全部执行完返回true，令牌用完返回false
+     */
+    bool run_plan(int disk_id, std::string& action, int& tokens) {
+        Disk& disk = disks[disk_id];
+        DiskQueue& queue = disk_queues[disk_id];
+        std::vector<int>& offsets = queue.plan_offsets;
+        offsets.clear();
+        int horizon = std::min(disk.size, G * LOOKAHEAD_SLICES);
+        // 从磁头位置开始收集前方的待读块，到磁盘末尾后绕回开头，至少包含最近的一个
+        auto it = queue.pending_units.lower_bound(disk.head_point);
+        while (static_cast<int>(offsets.size()) < HeadPlanner::MAX_PLAN_BLOCKS) {
+            if (it == queue.pending_units.end())
+                it = queue.pending_units.begin();
+            int offset = (it->first - disk.head_point + disk.size) % disk.size;
+            if (!offsets.empty() && (offset >= horizon || offset <= offsets.back()))
+                break;
+            offsets.emplace_back(offset);
+            ++it;
+        }
+
+        const std::vector<char>& read_through = queue.planner.plan(offsets, HeadPlanner::level_of(disk.last_action_is_read, disk.last_token_cost));
+        int moved = 0;  // 已经移动的距离
+        for (size_t i = 0; i < read_through.size(); i++) {
+            if (read_through[i]) {
+                for (; moved < offsets[i]; moved++) {
+                    if (!read_unit(disk_id, action, tokens))
+                        return false;
+                }
+            }
+            else if (moved < offsets[i]) {
+                int gap = offsets[i] - moved;
+                moved += pass_units(disk, action, tokens, gap);
+                if (moved < offsets[i])
+                    return false;
+            }
+            if (!read_unit(disk_id, action, tokens))
+                return false;
+            moved++;
+        }
+        return true;
+    }
+
     /*
-     * @Description: 选择最合适的3个不同磁盘作为写入磁盘
-     * @param object_id: 要写入的对象ID
-     * @return: 选择的3个不同磁盘ID，-1表示没有合适的磁盘
-    */
-    std::vector<int> select_write_disk(int object_id, int tag, int size) {
-        // <int, score>，int为disk_id, score为优先级得分
-        std::vector<std::pair<int, float>> candidate_disks;
-        
+     * @Description: 磁盘没有待读块时，找出预计接下来读请求最多的标签区域
+     * 标签在该磁盘上的预计读取量 = 本 epoch 预测的读取块数 × 该磁盘存放的该标签块数占所有磁盘的比例
+     * @return: 该标签区域的 [起始单元, 结束单元]，没有标签区域或者磁盘上没有数据时返回 {-1, -1}
+     */
+    std::pair<int, int> idle_target(int disk_id) const {
+        const Disk& disk = disks[disk_id];
+        if (disk.tag_zone_start.empty() || disk.used_units == 0)
+            return {-1, -1};
+        int best_tag = -1;
+        double best_reads = 0;
+        for (int tag = 1; tag <= numTag; tag++) {
+            if (disk.tag_slot_num[tag] == 0)
+                continue;
+            long long total_blocks = 0;
+            for (int i = 1; i <= numDisks; i++) {
+                total_blocks += disks[i].tag_slot_num[tag];
+            }
+            int epoch = std::min((std::max(current_timestamp, 1) - 1) / FRE_PER_SLICING + 1, static_cast<int>(tag_info[tag].size()) - 1);
+            double reads = static_cast<double>(tag_info[tag][epoch][2]) * disk.tag_slot_num[tag] / total_blocks;
+            if (best_tag == -1 || reads > best_reads) {
+                best_tag = tag;
+                best_reads = reads;
+            }
+        }
+        if (best_tag == -1)
+            return {-1, -1};
+        return {disk.tag_zone_start[best_tag], disk.tag_zone_start[best_tag + 1] - 1};
+    }
+
+    /*
+     * @Description: 空闲的磁头提前向 idle_target 区域的开头移动，下一个读请求到达时少走一段
+     * 已经在该区域内时不动；只用 Pass 移动，一个时间片最多走G步：跳转要占用整个时间片，
+     * 期间到达的请求要多等一个时间片，实测比逐步 Pass 过去差
+     */
+    void preposition_head(int disk_id, std::string& action) {
+        Disk& disk = disks[disk_id];
+        std::pair<int, int> zone = idle_target(disk_id);
+        if (zone.first == -1 || (disk.head_point >= zone.first && disk.head_point <= zone.second))
+            return;
+        int distance = (zone.first - disk.head_point + disk.size) % disk.size;
+        int tokens = G;
+        pass_units(disk, action, tokens, distance);
+    }
+
+    /*
+     * @Description: 一个时间片内移动 disk_id 号磁盘的磁头
+     * 磁头只向前移动，依次读取经过的待读块，一个块读完后，等待该块的所有请求都记下这一块
+     * @param action: 磁头的动作
+     */
+    void run_head(int disk_id, std::string& action) {
+        Disk& disk = disks[disk_id];
+        std::map<int, std::vector<PendingRead>>& pending_units = disk_queues[disk_id].pending_units;
+        action.clear();
+
+        if (pending_units.empty()) {
+            preposition_head(disk_id, action);
+            action += '#';
+            return;
+        }
+
+        int tokens = this->G;
+        while (!pending_units.empty()) {
+            // 磁头前方最近的待读块，到磁盘末尾后绕回开头
+            auto it = pending_units.lower_bound(disk.head_point);
+            if (it == pending_units.end())
+                it = pending_units.begin();
+            int cur_unit = it->first;
+            int distance = (cur_unit - disk.head_point + disk.size) % disk.size;
+            // 如果使用全部token也空转不过去，就直接跳过去
+            if (tokens == G && distance >= G) {
+                action = "j " + std::to_string(cur_unit);
+                disk.head_point = cur_unit;
+                disk.last_action_is_read = false;
+                disk.last_token_cost = G;
+                if (Telemetry::ENABLED)
+                    telemetry.disk(disk_id).jump_tokens = G;
+                return;
+            }
+            if (head_policy == HeadPolicy::LOOKAHEAD) {
+                if (!run_plan(disk_id, action, tokens))
+                    break;
+                continue;
+            }
+            // 空转过去，令牌不够时尽量靠近
+            if (distance != 0 && pass_units(disk, action, tokens, distance) < distance)
+                break;
+            // distance==0，能读就读，否则等到下个时间片
+            if (!read_unit(disk_id, action, tokens))
+                break;
+        }
+        action += '#';
+    }
+
+    // 从 write_scores[1..numDisks] 中选出得分最高的 REP_NUM 个磁盘（得分相同时编号小的优先），扫描一遍，不排序
+    bool select_top_disks(int disk_ids[REP_NUM]) const {
+        if (numDisks < REP_NUM)
+            return false;
+        int n = 0;
         for (int i = 1; i <= numDisks; ++i) {
-            Disk& disk = disks[i];
-            // 对象越大，越需要有连续的空间可以存储该对象，否则每次读的耗时就越大
-            // 用 size_ratio 表示这个对象对连续空间的依赖程度
-            float size_ratio = (float)size / (float)MAX_OBJ_SIZE;
-            // 1. 足够存放的连续空间（70%~90%权重，减少碎片）
-            float contiguous_weight = 0.7f + size_ratio * 0.2f;
-            // 2. 尽量选择与该对象同标签少的磁盘（10%~20%权重，平衡负载），有利于不同标签对象的并行读取
-            float tag_weight = 1.0f - contiguous_weight;
-
-            float contiguous_score = static_cast<float>(disk.sfl.get_largest_free_block_size()) / (float)MAX_OBJ_SIZE; // 归一化到[0,1]范围
-            float tag_score = 1.0f - (static_cast<float>(disk.tag_slot_num[tag]) / static_cast<float>(disk.size));
-            float total_score = (contiguous_score * contiguous_weight) + (tag_score * tag_weight);
-            // 如果已使用空间超过90%，则不能选择该磁盘
-            // 用下面这种判断只是为了免去转换到float
-            if (disk.used_units * 10 > 9 * disk.size)
-                total_score = -1;
-            
-            candidate_disks.emplace_back(disk.id, total_score);
+            int pos;
+            if (n < REP_NUM) {
+                pos = n++;
+            }
+            else if (write_scores[i] > write_scores[disk_ids[REP_NUM - 1]]) {
+                pos = REP_NUM - 1;
+            }
+            else {
+                continue;
+            }
+            // 插入到前 REP_NUM 名中
+            while (pos > 0 && write_scores[i] > write_scores[disk_ids[pos - 1]]) {
+                disk_ids[pos] = disk_ids[pos - 1];
+                pos--;
+            }
+            disk_ids[pos] = i;
+        }
+        return true;
+    }
+
+    // 把对象的三个副本写入选好的磁盘，保存到 saved_objects
+    void place_object(Object& obj, const int disk_ids[REP_NUM]) {
+        for (int i = 0; i < REP_NUM; i++) {
+            int disk_id = disk_ids[i];
+            // 直接分配到副本的内联数组中
+            obj.replicas[i].disk_id = disk_id;
+            if (!allocate_units(disks[disk_id], obj.tag, obj.size, obj.replicas[i].units)) {
+                fprintf(stderr, "fail to allocate units\n");
+                return;
+            }
+            disks[disk_id].occupancy.set_units(obj.replicas[i].units, obj.size);
+            for (int b = 1; b <= obj.size; b++) {
+                disks[disk_id].unit_object[obj.replicas[i].units[b]] = obj.id;
+                disks[disk_id].unit_block[obj.replicas[i].units[b]] = static_cast<unsigned char>(b);
+            }
+            disks[disk_id].tag_slot_num[obj.tag] += obj.size;
+            disks[disk_id].used_units += obj.size;
         }
 
+        saved_objects.insert(obj);
+    }
 
-        std::sort(candidate_disks.begin(), candidate_disks.end(),
-            [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
-                return a.second > b.second;
-            });
+    // 开始新的一批写入，清空本批在各磁盘上写入的块数
+    void begin_write_batch() {
+        std::fill(batch_units.begin(), batch_units.end(), 0);
+        batch_total = 0;
+    }
 
-        if (candidate_disks.size() < 3)
-            return {};
-        else
-            return std::vector<int>({candidate_disks[0].first, candidate_disks[1].first, candidate_disks[2].first});
+    /*
+     * @Description: 在当前这批写入中放置一个对象
+     * 每个磁盘的得分由 DiskSelectionPolicy 按磁盘当前状态和标签当前的相对热度重新计算（剩余空间、标签块数在每次写入时更新），
+     * 再减去本批已经写入该磁盘的块数占比，使一批写入均匀分布到各个磁盘上，之后的读取负载也更均衡
+     * @return: 没有足够的磁盘时返回false
+     */
+    bool write_in_batch(Object& obj) {
+        float total_heat = 0;
+        for (int tag = 1; tag <= numTag; tag++) {
+            total_heat += get_current_heat(tag);
+        }
+        float relative_heat = total_heat > 0 ? get_current_heat(obj.tag) * numTag / total_heat : 1.0f;
+        for (int i = 1; i <= numDisks; ++i) {
+            write_scores[i] = DiskSelectionPolicy::score(disks[i], obj.tag, obj.size, relative_heat);
+            if (batch_total > 0)
+                write_scores[i] -= BATCH_LOAD_WEIGHT * batch_units[i] / batch_total;
+        }
+        int disk_ids[REP_NUM];
+        if (!select_top_disks(disk_ids)) {
+            fprintf(stderr, "Not enough available disks\n");
+            return false;
+        }
+        place_object(obj, disk_ids);
+        for (int i = 0; i < REP_NUM; i++) {
+            batch_units[disk_ids[i]] += obj.size;
+        }
+        batch_total += obj.size * REP_NUM;
+        return true;
+    }
+
+    /*
+     * @Description: 根据预处理的标签信息把每个磁盘划分成标签区域
+     * 每个标签的区域大小与它预计的最大存活数据量（累计写入减删除的峰值）成正比
+     */
+    void plan_tag_zones() {
+        std::vector<long long> peak(numTag + 1, 0);
+        long long total = 0;
+        for (int tag = 1; tag <= numTag; tag++) {
+            long long live = 0;
+            for (int e = 1; e < static_cast<int>(tag_info[tag].size()); e++) {
+                live += tag_info[tag][e][1] - tag_info[tag][e][0];
+                peak[tag] = std::max(peak[tag], live);
+            }
+            total += peak[tag];
+        }
+        if (total == 0)
+            return;
+
+        for (int i = 1; i <= numDisks; ++i) {
+            Disk& disk = disks[i];
+            disk.tag_zone_start.assign(numTag + 2, disk.size + 1);
+            long long prefix = 0;
+            for (int tag = 1; tag <= numTag; tag++) {
+                disk.tag_zone_start[tag] = 1 + static_cast<int>(prefix * disk.size / total);
+                prefix += peak[tag];
+            }
+        }
+    }
+
+    /*
+     * @Description: 为对象在磁盘上分配存储单元
+     * 优先在该标签的区域内按地址顺序放置，使同标签对象相邻；区域内没有连续空间时退回到整个磁盘上分配
+     * 磁头在区域内时从磁头位置往后找，放在磁头接下来会扫过的位置，新对象的读请求到达时不用再转一圈，找不到再从区域开头找
+     */
+    bool allocate_units(Disk& disk, int tag, int size, int* units) {
+        if (!disk.tag_zone_start.empty()) {
+            int zone_first = disk.tag_zone_start[tag], zone_last = disk.tag_zone_start[tag + 1] - 1;
+            int start = -1;
+            if (disk.head_point > zone_first && disk.head_point <= zone_last)
+                start = disk.occupancy.find_free_run_in(size, disk.head_point, zone_last);
+            if (start == -1)
+                start = disk.occupancy.find_free_run_in(size, zone_first, zone_last);
+            if (start != -1)
+                return disk.sfl.allocate_range(start, size, units);
+        }
+        return disk.sfl.allocate(size, units);
     }
 
      // TODO: 完善优先级算法
@@ -93,278 +659,359 @@ private:
      void set_priority(int request_id) {
         Request& req = requests[request_id];
         if (req.status == Status::COMPLETED) {  // 如果已经完成，优先级最低
-            req.priority = 0;
+            req.priority = PriorityPolicy::COMPLETED_PRIORITY;
             return;
         }
         if (req.status == Status::READING) {  // 如果正在读，优先级最高
-            req.priority = 10000000;
+            req.priority = PriorityPolicy::READING_PRIORITY;
             return;
         }
         // 简单地计算三个副本所在磁盘的磁头分别到该对象第一个存储单元的距离作为距离权重
         float distance_weight = 0.0f;
         for (int i = 0; i < REP_NUM; i++) {
-            distance_weight += static_cast<float>((saved_objects[req.object_id].replicas[i].units[0] + disks[i].size - disks[saved_objects[req.object_id].replicas[i].disk_id].head_point) % disks[i].size);
+            // units[0] 是占位元素，第一个存储单元是 units[1]
+            Replica& replica = saved_objects.replica(req.object_id, i);
+            Disk& disk = disks[replica.disk_id];
+            distance_weight += static_cast<float>((replica.units[1] + disk.size - disk.head_point) % disk.size);
         }
         // 标签热度越高越优先读
-        int epoch = (req.start_timestamp - 1) / FRE_PER_SLICING + 1;
-        float tag_weight = tag_heat[saved_objects[req.object_id].tag][epoch];
+        float tag_weight = heat_model.get(saved_objects.tag(req.object_id));
+
+        // 越接近截止时间越优先
+        float age_weight = static_cast<float>(current_timestamp - req.start_timestamp) / EXTRA_TIME;
 
         // 综合计算优先级
-        req.priority = distance_weight * 0.4f + tag_weight * 0.6f;
+        req.priority = PriorityPolicy::score(distance_weight, tag_weight, age_weight, disks[1].size);
+    }
+
+    // 时间片结束时记录每个磁盘的空间状态，写出本时间片的统计
+    void record_telemetry() {
+        for (int i = 1; i <= numDisks; i++) {
+            DiskTelemetry& record = telemetry.disk(i);
+            record.pending_units = static_cast<int32_t>(disk_queues[i].pending_units.size());
+            record.free_units = disks[i].occupancy.count_free();
+            record.free_runs = disks[i].occupancy.count_free_runs();
+        }
+        // 排队的请求、被准入控制拒绝还没超时的请求，加上已经分配给各磁盘的请求
+        int backlog = static_cast<int>(requests_queue.size());
+        for (int req_id : rejected_requests) {
+            if (requests.find(req_id) != nullptr)
+                backlog++;
+        }
+        for (int i = 1; i <= numDisks; i++) {
+            backlog += disk_queues[i].request_count;
+        }
+        telemetry.end_slice(current_timestamp, backlog);
     }
 
 public:
-    DiskScheduler(int M, int numDisks, int disk_size, int G, std::vector<std::vector<std::vector<int>>> tag_info, std::vector<std::vector<float>> tag_heat)
-        : disks(MAX_DISK_NUM), working_disks(MAX_DISK_NUM),
-        requests_queue([this](int request_id1, int request_id2) -> bool {
-            Request& req1 = requests[request_id1];
-            Request& req2 = requests[request_id2];
-            return req1.priority < req2.priority;
-            })
+    BasicDiskScheduler(int M, int numDisks, int disk_size, int G, std::vector<std::vector<std::vector<int>>> tag_info, std::vector<std::vector<float>> tag_heat,
+                  ReadMode read_mode = ReadMode::SWEEP, HeadPolicy head_policy = HeadPolicy::LOOKAHEAD)
+        : disks(MAX_DISK_NUM), deadline_wheel(EXTRA_TIME + 1), requests_queue(RequestPool::HeapPosition{&requests}), disk_queues(MAX_DISK_NUM),
+          write_scores(MAX_DISK_NUM), batch_units(MAX_DISK_NUM)
     {
         this->numTag = M;
         this->numDisks = numDisks;
         this->G = G;
+        this->read_mode = read_mode;
+        this->head_policy = head_policy;
         for (int i = 1; i <= numDisks; ++i) {
             disks[i] = Disk(i, disk_size);
+            disks[i].tag_slot_num.assign(M + 1, 0);
         }
         this->tag_info = tag_info;
         this->tag_heat = tag_heat;
+        this->heat_model = TagHeatEstimator(M);
+        plan_tag_zones();
+        telemetry.open(numDisks, G);
+    }
+
+    // 设置移动磁头的线程数（包括主线程），1 表示串行
+    void set_read_threads(int num_threads) {
+        if (num_threads > 1)
+            read_pool.reset(new ThreadPool(std::min(num_threads, numDisks)));
+        else
+            read_pool.reset();
     }
 
     void add_request(int req_id, int object_id, int timestamp) {
-        Request req(req_id, object_id, timestamp);
-        requests[req_id] = req;
-        // ? 如果优先级是动态更新的，这里需要处理
+        requests.insert(Request(req_id, object_id, saved_objects.size(object_id), timestamp));
+        heat_model.on_read(saved_objects.tag(object_id), saved_objects.size(object_id));
+        telemetry.on_arrive();
+        object_requests[object_id].emplace_back(req_id);
+        deadline_wheel[timestamp % (EXTRA_TIME + 1)].emplace_back(req_id);
+        for (int b = 1; b <= saved_objects.size(object_id); b++) {
+            saved_objects.pending_reads(object_id, b)++;
+        }
+        // 优先级在 age_requests 中随请求变老重新计算
         set_priority(req_id);  // 计算优先级
-        requests_queue.push(req_id);
+        requests_queue.push(req_id, requests[req_id].priority);
+    }
+
+    /*
+     * @Description: 每个时间片开始时调用，处理时间轮
+     * 到达 EXTRA_TIME 个时间片的请求再完成也是0分，从请求队列和磁盘的待读集合中移除；
+     * SINGLE_TASK 模式下，年龄到达 AGE_CHECKPOINTS 的排队请求重新计算优先级；
+     * SWEEP 模式下请求一到就出队分配给磁盘，磁头按位置扫描，没有排队的请求需要重新评分
+     * @param timestamp: 当前时间片
+     * @return: 本时间片超时的请求id
+     */
+    std::vector<int> age_requests(int timestamp) {
+        static const int AGE_CHECKPOINTS[] = {10, 40, 70, 90};
+        current_timestamp = timestamp;
+        heat_model.advance(timestamp);
+        std::vector<int> expired_request_ids;
+        if (timestamp - EXTRA_TIME >= 1) {
+            std::vector<int>& bucket = deadline_wheel[(timestamp - EXTRA_TIME) % (EXTRA_TIME + 1)];
+            for (int req_id : bucket) {
+                if (requests.find(req_id) == nullptr)
+                    continue;
+                expire_request(req_id);
+                expired_request_ids.emplace_back(req_id);
+            }
+            // 请求id按到达顺序递增，这个桶之前到达的请求都已经不在请求池中
+            if (!bucket.empty())
+                requests.release_before(bucket.back() + 1);
+            bucket.clear();
+            telemetry.on_expire(static_cast<int>(expired_request_ids.size()));
+        }
+        if (read_mode != ReadMode::SINGLE_TASK)
+            return expired_request_ids;
+        for (int age : AGE_CHECKPOINTS) {
+            if (timestamp - age < 1)
+                continue;
+            for (int req_id : deadline_wheel[(timestamp - age) % (EXTRA_TIME + 1)]) {
+                Request* req = requests.find(req_id);
+                if (req == nullptr || req->status != Status::PENDING)
+                    continue;
+                set_priority(req_id);
+                requests_queue.update(req_id, req->priority);
+            }
+        }
+        return expired_request_ids;
     }
 
     void update_tag_heat(int epoch) {
         // 计算每个标签在每个epoch中的热度
         // 在一个窗口内的epoch中，读得越多越热，删得越少越热，tag_heat[t][e] = tag_info[t][e, e + 1, ...][read] /...[delete]
+        // 最后 EXTRA_TIME 个时间片属于第 n_epoch + 1 个 epoch，没有预测数据，沿用最后一个 epoch 的预测热度
+        if (numTag < 1 || epoch >= static_cast<int>(tag_heat[1].size()))
+            return;
         std::vector<int> read_sum(numTag + 1, 0);    // 每个标签在每个epoch中的读的数量
         std::vector<int> delete_sum(numTag + 1, 0);  // 每个标签在每个epoch中的删除的数量
         for (int tag = 1; tag <= numTag; tag++) {
-            for (int i = epoch; i < tag_info[1].size() && i < epoch + WINDOW_SIZE; i++) {
+            for (int i = epoch; i < static_cast<int>(tag_info[1].size()) && i < epoch + WINDOW_SIZE; i++) {
                 read_sum[tag] += tag_info[tag][i][2];
                 delete_sum[tag] += tag_info[tag][i][0]; 
             }
             tag_heat[tag][epoch] = static_cast<float>(read_sum[tag]) / (static_cast<float>(delete_sum[tag]) + 1.0); // 加1防止除以0;
+            heat_model.set_forecast(tag, tag_heat[tag][epoch]);
         }
     }
 
+    // 预处理预测的热度
     float get_heat(int tag, int epoch) const {
         return tag_heat[tag][epoch];
     }
 
+    // 当前时间片的在线热度
+    float get_current_heat(int tag) const {
+        return heat_model.get(tag);
+    }
+
     /*
-     * @Description: 删除对象，释放磁盘空间
+     * @Description: 删除对象，释放磁盘空间，并撤销该对象还没完成的请求
      * @param object_id: 要删除的对象ID
-     * @return: 若删除的对象在请求队列中，返回被删除的请求id数组，否则返回{}
+     * @return: 被撤销的请求id数组，没有则返回{}
      */
     std::vector<int> delete_object(int object_id) {
-        if (saved_objects.find(object_id) == saved_objects.end())
-            return {};
-        
-        Object& obj = saved_objects[object_id];
+        std::vector<int> deleted_request_ids;
+        delete_object(object_id, deleted_request_ids);
+        return deleted_request_ids;
+    }
+
+    /*
+     * @Description: 批量删除一个时间片内的所有对象
+     * @param object_ids: 要删除的对象ID数组
+     * @return: 被撤销的请求id数组
+     */
+    std::vector<int> delete_objects(const std::vector<int>& object_ids) {
+        std::vector<int> deleted_request_ids;
+        for (int object_id : object_ids) {
+            delete_object(object_id, deleted_request_ids);
+        }
+        return deleted_request_ids;
+    }
+
+    /*
+     * @Description: 删除对象，被撤销的请求id追加到 deleted_request_ids
+     * 耗时只和该对象的请求数有关，不需要遍历全部请求和重建请求队列
+     */
+    void delete_object(int object_id, std::vector<int>& deleted_request_ids) {
+        if (!saved_objects.contains(object_id))
+            return;
+
+        int size = saved_objects.size(object_id);
+        int tag = saved_objects.tag(object_id);
+        heat_model.on_delete(tag, size);
         // 释放三个副本
         for (int i = 0; i < REP_NUM; i++) {
-            int disk_id = obj.replicas[i].disk_id;
-            // 获取该副本的存储单元分配信息
-            std::vector<int>& units = obj.replicas[i].units;
+            Replica& replica = saved_objects.replica(object_id, i);
+            int disk_id = replica.disk_id;
             
             // 调用对应磁盘的释放函数
-            disks[disk_id].sfl.freeBlock(units);
-            disks[disk_id].tag_slot_num[obj.tag] -= obj.size;
-            disks[disk_id].used_units -= obj.size;
+            disks[disk_id].sfl.freeBlock(replica.units, size);
+            disks[disk_id].occupancy.clear_units(replica.units, size);
+            for (int b = 1; b <= size; b++) {
+                disks[disk_id].unit_object[replica.units[b]] = 0;
+            }
+            disks[disk_id].tag_slot_num[tag] -= size;
+            disks[disk_id].used_units -= size;
         }
 
-        saved_objects.erase(object_id);
         // 如果删除时还没读完，就撤销
-        std::vector<int> deleted_request_ids;
-        for (std::pair<const int, Request>& Irequest : requests) {
-            Request& request = Irequest.second;
-            if (request.object_id == object_id) {
-                request.status = Status::COMPLETED;
-                for (int k = 1; k <= numDisks; k++) {
-                    if (working_disks[k].request_id == request.req_id) {
-                        working_disks[k].request_id = -1;
-                        working_disks[k].unit_to_be_read = std::queue<int>();
-                        break;
-                    }
-                }
-
-                // 从requests_queue中删除该请求，创建一个新的临时 priority_queue
-                RequestQueue new_queue;
-                // 逐个取出元素，重新插入到新队列（跳过要删除的元素）
-                while (!requests_queue.empty()) {
-                    int top = requests_queue.top();
-                    requests_queue.pop();
-                    if (top != request.req_id) {
-                        new_queue.push(top);
-                    }
-                }
-                // 用新的队列替换旧的队列
-                requests_queue = std::move(new_queue);
-
-                deleted_request_ids.emplace_back(request.req_id);
+        int aborted = 0;
+        auto req_it = object_requests.find(object_id);
+        if (req_it != object_requests.end()) {
+            for (int req_id : req_it->second) {
+                Request& request = requests[req_id];
+                // 已经分配给磁盘的请求，从负责磁盘的待读集合中移除
+                if (request.is_assigned())
+                    unassign_request(req_id);
+                requests_queue.erase(req_id);
+                requests.erase(req_id);
+                deleted_request_ids.emplace_back(req_id);
             }
+            aborted += static_cast<int>(req_it->second.size());
+            object_requests.erase(req_it);
         }
-        if (deleted_request_ids.empty()) {
-            return {};
-        } else {
-            return deleted_request_ids;
+        // 超时的请求已经不在请求池中，只需要上报
+        auto expired_it = expired_requests.find(object_id);
+        if (expired_it != expired_requests.end()) {
+            deleted_request_ids.insert(deleted_request_ids.end(), expired_it->second.begin(), expired_it->second.end());
+            aborted += static_cast<int>(expired_it->second.size());
+            expired_requests.erase(expired_it);
         }
+        telemetry.on_abort(aborted);
+        saved_objects.erase(object_id);
     }
 
     /*
-     * @Description: 写入对象到磁盘，保存写入对象信息到saved_objects
-     * @param obj: 要写入的对象
-     * @return: 写入的对象信息
+     * @Description: 写入单个对象到磁盘，保存写入对象信息到saved_objects，等同于只有这一个对象的 write_objects
+     * @param obj: 要写入的对象，写入后填好副本信息
      */
-    void write_object(Object& obj) {        
-        // 为三个副本选择不同磁盘
-        std::vector<int> selected_disks = select_write_disk(obj.id, obj.tag, obj.size);
-        if (selected_disks.size() < REP_NUM) {
-            printf("Not enough available disks\n");
-            return;
+    void write_object(Object& obj) {
+        begin_write_batch();
+        write_in_batch(obj);
+    }
+
+    /*
+     * @Description: 写入一个时间片的所有对象，按当前标签热度从高到低（一样高时大小从大到小）依次放置，兼顾本批写入在各磁盘间的均衡
+     * @param objects: 要写入的对象，返回时按写入顺序排列，并填好副本信息
+     */
+    void write_objects(std::vector<Object>& objects) {
+        auto comp = [this](const Object& a, const Object& b) {
+            float a_heat = heat_model.get(a.tag), b_heat = heat_model.get(b.tag);
+            if (a_heat != b_heat)
+                return a_heat < b_heat;
+            else
+                return a.size < b.size;
+            };
+        std::priority_queue<Object, std::vector<Object>, decltype(comp)> objects_to_be_written(comp);
+        for (const Object& obj : objects) {
+            objects_to_be_written.emplace(obj);
         }
+        objects.clear();
 
-        for (int i = 0; i < REP_NUM; i++) {
-            int disk_id = selected_disks[i];
-            std::vector<int> allocated = disks[disk_id].sfl.allocate(obj.size);
-            if (allocated.empty()) {
-                printf("fail to allocate units\n");
-                return;
-            }
-            // 记录分配信息（带磁头优化标记）
-            obj.replicas[i] = {disk_id, allocated};
-            disks[disk_id].tag_slot_num[obj.tag] += obj.size;
-            disks[disk_id].used_units += obj.size;
+        // 整批一起放置，见 write_in_batch
+        begin_write_batch();
+        while (!objects_to_be_written.empty()) {
+            objects.emplace_back(objects_to_be_written.top());
+            objects_to_be_written.pop();
+            write_in_batch(objects.back());
         }
-        
-        saved_objects[obj.id] = obj;
     }
 
     /*
-     * @Description: 在一个时间片中对每个磁盘进行动作，一个请求在一个磁盘上完成读取
+     * @Description: 在一个时间片中对每个磁盘进行动作，先把请求分配给副本所在的磁盘，再移动每个磁头
      * @param points_action: 存储每个磁头的动作
      * @param completed_requests: 存储可以上报的请求id
      */
-    // TODO: 之后针对比较碎片化的对象，可以改成并行读取。
     void read_one_timeslice(std::vector<std::string>& points_action, std::vector<int>& completed_requests) {
         std::vector<int> staging_requests;  // 用于存储优先级较高但没有磁盘可以负责的请求，之后重新入队
-        // 尽量让每个磁盘都有工作
-        while (!requests_queue.empty() && have_idle_disk()) {
+        // 被准入控制拒绝的请求在所有磁盘的待读单元总数降到拒绝时的一半以下后重新入队检查，
+        // 积压稍有下降就检查时每个时间片要重新评估大量请求，读阶段慢一半以上，分数也没有提高；
+        // 已经完成、超时或被删除的请求从列表中去掉
+        int pending_total = 0;
+        for (int i = 1; i <= numDisks; i++) {
+            pending_total += static_cast<int>(disk_queues[i].pending_units.size());
+        }
+        size_t kept = 0;
+        for (int req_id : rejected_requests) {
+            Request* req = requests.find(req_id);
+            if (req == nullptr)
+                continue;
+            if (pending_total * 2 < req->rejected_backlog)
+                requests_queue.push(req_id, req->priority);
+            else
+                rejected_requests[kept++] = req_id;
+        }
+        rejected_requests.resize(kept);
+        while (!requests_queue.empty()) {
+            // SINGLE_TASK 模式下尽量让每个磁盘都有工作，SWEEP 模式下所有请求都立即分配
+            if (read_mode == ReadMode::SINGLE_TASK && !have_idle_disk())
+                break;
             // 从请求队列中取出优先级最高的请求
             int best_req_id = requests_queue.top();
-            // 如果是已经被删除的对象，状态会是 COMPLETED
-            // 注意这里不会是经过读取后的完成状态，那种情况会在后面被直接处理
-            if (requests.find(best_req_id) == requests.end()) {
-                requests_queue.pop();
+            requests_queue.pop();
+            // 被删除对象的请求已经出队，这里只是防御
+            Request* best_req = requests.find(best_req_id);
+            if (best_req == nullptr)
                 continue;
-            }
 
-            // 简单地查看该请求对象的三个副本所在磁盘哪个是空闲的
-            // TODO: 可以优化选择算法
-            int request_object_id = requests[best_req_id].object_id;
-            bool found_free_disk = false;
-            for (int i = 0; i < REP_NUM; i++) {
-                int cur_disk_id = saved_objects[request_object_id].replicas[i].disk_id;
-                // working_disks 中没有该磁盘，用该磁盘负责该请求
-                if (working_disks[cur_disk_id].request_id == -1) {
-                    std::queue<int> to_be_read;
-                    for (int j = 1; j < saved_objects[request_object_id].replicas[i].units.size(); j++) {
-                        to_be_read.push(saved_objects[request_object_id].replicas[i].units[j]);
-                    }
-                    Task task = {best_req_id, request_object_id, cur_disk_id, to_be_read};
-                    working_disks[cur_disk_id] = task;
-                    requests[best_req_id].responsible_disk_id = cur_disk_id;
-                    requests[best_req_id].status = Status::READING;
-                    found_free_disk = true;
-                    requests_queue.pop();
-                    break;
-                }
-            }
-            if (!found_free_disk) {
+            if (!select_read_disks(*best_req)) {
                 staging_requests.emplace_back(best_req_id);
+                continue;
+            }
+            // 准入控制：预计在截止时间前读不完的请求不分配给磁盘，令牌留给还能得分的请求；
+            // 它离开请求队列，放到 rejected_requests 中，积压下降后再重新检查，期间被顺路读完仍然算完成。
+            // SINGLE_TASK 模式下只选空闲磁盘，几乎不会被拒绝，检查照样进行
+            if (!can_meet_deadline(*best_req)) {
+                std::fill(best_req->block_disk, best_req->block_disk + MAX_OBJ_SIZE + 1, 0);
+                best_req->rejected_backlog = pending_total;
+                rejected_requests.emplace_back(best_req_id);
+                continue;
             }
+            assign_request(best_req_id);
+            telemetry.on_start();
         }
 
         // 归还取出之后没有被负责的请求
         for (int req_id : staging_requests) {
-            requests_queue.push(req_id);
+            requests_queue.push(req_id, requests[req_id].priority);
         }
 
-        // 开始读取操作
-        for (int i = 1; i <= numDisks; i++) {
-            // 该磁盘没有工作
-            if (working_disks[i].request_id == -1) {
-                points_action[i] = "#";
-                continue;
-            }
-            int cur_req_id = working_disks[i].request_id;
-            int cur_obj_id = working_disks[i].object_id;
-            std::queue<int>& unit_to_be_read = working_disks[i].unit_to_be_read;
-
-            int tokens = this->G;
-            while (tokens > 0 && !unit_to_be_read.empty()) {
-                // 将磁头移动到第一个要读取的存储块
-                int head_pos = disks[i].head_point;
-                int cur_unit = unit_to_be_read.front();
-                int distance = (cur_unit + disks[i].size - head_pos) % disks[i].size;   // 计算距离不用考虑索引从0还是1开始的问题
-                // 如果使用全部token也空转不过去，就直接跳过去
-                if (tokens == G && distance >= tokens) {
-                    tokens = 0;
-                    points_action[i] = "j " + std::to_string(cur_unit);
-                    disks[i].head_point = cur_unit;
-                    disks[i].last_action_is_read = false;
-                    disks[i].last_token_cost = G;
-                }
-                // 空转过去
-                else if (distance != 0) {
-                    // 计算移动距离所需的时间
-                    tokens -= distance; // 消耗时间
-                    for (int k = 0; k < distance; k++) {
-                        points_action[i] += "p";
-                    }
-                    disks[i].head_point = cur_unit;
-                    disks[i].last_action_is_read = false;
-                    disks[i].last_token_cost = distance;
-                }
-                // distance==0，能读就读，否则等到下个时间片
-                else {
-                    int cost_token = disks[i].last_action_is_read ? std::max(16, static_cast<int>(std::ceil(static_cast<double>(disks[i].last_token_cost) * 0.8))) : 64;
-                    // 等到下个时间片再读
-                    if (tokens < cost_token) {            
-                        if (unit_to_be_read.empty()) {
-                           completed_requests.emplace_back(cur_req_id);
-                           working_disks[i].request_id = -1;
-                           requests[cur_req_id].status = Status::COMPLETED;
-                           requests.erase(cur_req_id);
-                        }
-                        break;
-                    }
-                    else {
-                        tokens -= cost_token;
-                        points_action[i] += "r";
-                        disks[i].head_point = (disks[i].head_point % disks[i].size) + 1;    // 索引从1开始
-                        disks[i].last_action_is_read = true;
-                        disks[i].last_token_cost = cost_token;
-                        unit_to_be_read.pop();
-                        if (unit_to_be_read.empty()) {
-                            completed_requests.emplace_back(cur_req_id);
-                            working_disks[i].request_id = -1;
-                            requests[cur_req_id].status = Status::COMPLETED;
-                            requests.erase(cur_req_id);
-                        }
-                    }
-                }
+        // 开始读取操作，每个磁头只访问自己磁盘的状态，可以并行
+        if (read_pool) {
+            read_pool->run(numDisks, [&](int k) { run_head(k + 1, points_action[k + 1]); });
+        }
+        else {
+            for (int i = 1; i <= numDisks; i++) {
+                run_head(i, points_action[i]);
             }
-            if (points_action[i].empty() || points_action[i][0] != 'j') {
-                points_action[i] += "#";
+        }
+
+        // 按磁盘编号顺序把读到的块记到请求上，所有块都读到的请求完成，串行和并行的输出完全相同
+        for (int i = 1; i <= numDisks; i++) {
+            for (const BlockRead& read : disk_queues[i].read_blocks) {
+                credit_block(i, read, completed_requests);
             }
+            disk_queues[i].read_blocks.clear();
         }
+
+        if (Telemetry::ENABLED)
+            record_telemetry();
     }
-};
\ No newline at end of file
+};
+
+using DiskScheduler = BasicDiskScheduler<>;
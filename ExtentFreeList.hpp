@@ -0,0 +1,164 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "limit.h"
+#include "FitPolicy.hpp"
+
+// 按地址索引的空闲区间管理器，接口与 SegregatedFreeList 相同
+// by_start 以起始地址为键，释放时用 lower_bound 找前后邻居，合并为 O(log n)
+// by_size 以 <大小, 起始地址> 为键，FitPolicy 为 WorstFit/BestFit，查找都是 O(log n)
+template <typename FitPolicy = WorstFit>
+class BasicExtentFreeList {
+private:
+    std::map<int, int> by_start;            // <start, size>
+    std::set<std::pair<int, int>> by_size;  // <size, start>
+    int free_units = 0;
+
+    void insert_extent(int start, int size) {
+        by_start.emplace(start, size);
+        by_size.emplace(size, start);
+        free_units += size;
+    }
+
+    void erase_extent(std::map<int, int>::iterator it) {
+        by_size.erase({it->second, it->first});
+        free_units -= it->second;
+        by_start.erase(it);
+    }
+
+    // 从 start 开始切出 size 个单元写入 out[0..size-1]，剩余部分重新插入
+    void take(std::map<int, int>::iterator it, int size, int* out) {
+        int start = it->first, extent_size = it->second;
+        erase_extent(it);
+        if (extent_size > size) {
+            insert_extent(start + size, extent_size - size);
+        }
+        for (int i = 0; i < size; ++i) {
+            out[i] = start + i;
+        }
+    }
+
+    /*
+     * 尝试分配连续的 size 大小的内存块
+     * @param units: 分配成功时写入 units[1..requestSize]（首元素占位）
+     * @return: 是否分配成功
+    */
+    bool allocate_contiguous(int requestSize, int* units) {
+        if (by_size.empty() || by_size.rbegin()->first < requestSize)
+            return false;
+        std::set<std::pair<int, int>>::iterator chosen;
+        if (FitPolicy::LARGEST_FIRST) {
+            chosen = std::prev(by_size.end());
+        }
+        else {
+            chosen = by_size.lower_bound({requestSize, 0});
+        }
+        take(by_start.find(chosen->second), requestSize, units + 1);
+        return true;
+    }
+
+    /*
+     * 没有足够大的连续空间时，依次从最大的空闲块中切出，使分段数最少
+     * @param units: 分配成功时按地址升序写入 units[1..requestSize]
+     * @return: 是否分配成功
+    */
+    bool allocate_noncontiguous(int requestSize, int* units) {
+        if (free_units < requestSize)
+            return false;
+        int filled = 0;
+        while (filled < requestSize) {
+            std::pair<int, int> largest = *by_size.rbegin();
+            int part = std::min(requestSize - filled, largest.first);
+            take(by_start.find(largest.second), part, units + 1 + filled);
+            filled += part;
+        }
+        // 按物理地址排序（提升读取效率）
+        std::sort(units + 1, units + requestSize + 1);
+        return true;
+    }
+
+    // 插入新释放的区间，并与前后相邻的空闲区间合并
+    void merge_and_insert(int start, int size) {
+        auto next = by_start.lower_bound(start);
+        if (next != by_start.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == start) {
+                start = prev->first;
+                size += prev->second;
+                erase_extent(prev);
+            }
+        }
+        if (next != by_start.end() && start + size == next->first) {
+            size += next->second;
+            erase_extent(next);
+        }
+        insert_extent(start, size);
+    }
+
+public:
+    BasicExtentFreeList() {}
+    // 初始化时整个磁盘内存从 1 到 totalSize 为连续空闲区域
+    BasicExtentFreeList(int totalSize) {
+        insert_extent(1, totalSize);
+    }
+
+    // 分配 requestSize 大小的内存块，写入 units[1..requestSize]
+    // 分配失败返回false
+    bool allocate(int requestSize, int* units) {
+        // 优先尝试分配连续空间
+        if (allocate_contiguous(requestSize, units))
+            return true;
+        return allocate_noncontiguous(requestSize, units);
+    }
+
+    // 分配从 start 开始的 size 个连续单元，这段空间必须完全空闲，输出格式与 allocate 相同
+    bool allocate_range(int start, int size, int* units) {
+        auto it = by_start.upper_bound(start);
+        if (it == by_start.begin())
+            return false;
+        --it;
+        int extent_start = it->first, extent_end = it->first + it->second;
+        if (start + size > extent_end)
+            return false;
+        erase_extent(it);
+        if (extent_start < start)
+            insert_extent(extent_start, start - extent_start);
+        if (start + size < extent_end)
+            insert_extent(start + size, extent_end - start - size);
+
+        for (int i = 1; i <= size; ++i) {
+            units[i] = start + i - 1;
+        }
+        return true;
+    }
+
+    // 释放磁盘块 allocated_units[1..size]，将其归还并与相邻空闲区间合并（首元素占位，默认已排序）
+    void freeBlock(const int* allocated_units, int size) {
+        int current_start = allocated_units[1];
+        int current_size = 1;
+        for (int i = 2; i <= size; ++i) {
+            if (allocated_units[i] == allocated_units[i - 1] + 1) {
+                current_size++;
+            } else {
+                merge_and_insert(current_start, current_size);
+                current_start = allocated_units[i];
+                current_size = 1;
+            }
+        }
+        merge_and_insert(current_start, current_size);
+    }
+
+    // 返回最大的空闲块size，超过 MAX_OBJ_SIZE 时按 MAX_OBJ_SIZE 计算，没有空闲块时为 0
+    int get_largest_free_block_size() const {
+        if (by_size.empty())
+            return 0;
+        return std::min(by_size.rbegin()->first, MAX_OBJ_SIZE);
+    }
+};
+
+using ExtentFreeList = BasicExtentFreeList<WorstFit>;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <unistd.h>
+
+// 交互协议的输入层：按块从标准输入读到缓冲区，手写整数解析
+// 只在缓冲区读完时才调用 read，read 有数据就返回，不会等待判题器还没发送的内容
+class FastReader {
+private:
+    static const int BUFFER_SIZE = 1 << 16;
+    char buffer[BUFFER_SIZE];
+    int pos = 0;
+    int len = 0;
+
+    // 返回当前字符，缓冲区读完时补充，输入结束返回 -1
+    int peek() {
+        if (pos == len) {
+            ssize_t n = ::read(STDIN_FILENO, buffer, BUFFER_SIZE);
+            if (n <= 0)
+                return -1;
+            pos = 0;
+            len = static_cast<int>(n);
+        }
+        return static_cast<unsigned char>(buffer[pos]);
+    }
+
+    // 跳过空白字符，返回下一个非空白字符
+    int skip_spaces() {
+        int c = peek();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            pos++;
+            c = peek();
+        }
+        return c;
+    }
+
+public:
+    int read_int() {
+        int c = skip_spaces();
+        bool negative = false;
+        if (c == '-') {
+            negative = true;
+            pos++;
+            c = peek();
+        }
+        int x = 0;
+        while (c >= '0' && c <= '9') {
+            x = x * 10 + (c - '0');
+            pos++;
+            c = peek();
+        }
+        return negative ? -x : x;
+    }
+
+    // 跳过一个由非空白字符组成的单词，例如 TIMESTAMP
+    void skip_token() {
+        int c = skip_spaces();
+        while (c != -1 && c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            pos++;
+            c = peek();
+        }
+    }
+};
+
+// 交互协议的输出层：每个阶段写入预先分配的缓冲区，阶段结束时 flush 一次
+class FastWriter {
+private:
+    static const int BUFFER_SIZE = 1 << 24;
+    static const int RESERVE = 32;  // 一个整数加分隔符最多占用的字节
+    std::vector<char> buffer;
+    int len = 0;
+
+    // 剩余空间不足 n 字节时先写出，保证任意长度的输出都不会越界
+    void ensure(int n) {
+        if (len + n > BUFFER_SIZE)
+            flush();
+    }
+
+public:
+    FastWriter() : buffer(BUFFER_SIZE) {}
+
+    void write_int(int x) {
+        ensure(RESERVE);
+        if (x < 0) {
+            buffer[len++] = '-';
+            x = -x;
+        }
+        char digits[12];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + x % 10);
+            x /= 10;
+        } while (x > 0);
+        while (n > 0)
+            buffer[len++] = digits[--n];
+    }
+
+    void write_char(char c) {
+        ensure(1);
+        buffer[len++] = c;
+    }
+
+    void write_str(const char* s, int n) {
+        while (n > 0) {
+            ensure(1);
+            int step = std::min(n, BUFFER_SIZE - len);
+            memcpy(buffer.data() + len, s, step);
+            len += step;
+            s += step;
+            n -= step;
+        }
+    }
+
+    void write_str(const std::string& s) {
+        write_str(s.data(), static_cast<int>(s.size()));
+    }
+
+    void flush() {
+        int written = 0;
+        while (written < len) {
+            ssize_t n = ::write(STDOUT_FILENO, buffer.data() + written, len - written);
+            if (n <= 0)
+                break;
+            written += static_cast<int>(n);
+        }
+        len = 0;
+    }
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+// 连续分配时选择空闲块的策略，作为 BasicExtentFreeList / BasicSegregatedFreeList 的模板参数
+struct WorstFit {
+    static constexpr bool LARGEST_FIRST = true;     // 取最大的空闲块，剩余部分仍然较大，适合后续写入
+};
+
+struct BestFit {
+    static constexpr bool LARGEST_FIRST = false;    // 取能放下的最小空闲块，保留大块给大对象
+};
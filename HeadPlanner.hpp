@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// 磁头动作规划
+// 连续读的令牌数按 64, 52, 42, 34, 28, 23, 19, 16 衰减，Pass 一次就要从 64 重新开始，
+// 所以经过两个待读块之间的小间隙时，把间隙也读过去（连读）可能比 Pass 过去更省令牌。
+// 对磁头前方的若干个待读块做动态规划，决定每个间隙是 Pass 还是连读，使总令牌数最少。
+class HeadPlanner {
+public:
+    static constexpr int LEVEL_NUM = 9;         // 连读状态数，0 表示上一个动作不是读
+    static constexpr int MAX_PLAN_BLOCKS = 32;  // 一次最多规划的待读块数
+
+    // 处于连读状态 level 时读一个块的令牌数
+    static int read_cost_at(int level) {
+        static const int READ_COST[LEVEL_NUM] = {64, 52, 42, 34, 28, 23, 19, 16, 16};
+        return READ_COST[level];
+    }
+
+    static int next_level(int level) {
+        return std::min(level + 1, LEVEL_NUM - 1);
+    }
+
+    // 由磁盘上一个动作换算连读状态
+    static int level_of(bool last_action_is_read, int last_token_cost) {
+        if (!last_action_is_read)
+            return 0;
+        for (int level = 0; level < LEVEL_NUM - 1; level++) {
+            if (read_cost_at(level) == last_token_cost)
+                return level + 1;
+        }
+        return LEVEL_NUM - 1;
+    }
+
+    /*
+     * @Description: 规划经过每个间隙的方式
+     * @param offsets: 待读块相对磁头的距离，升序，第一个可以为0
+     * @param level: 磁头当前的连读状态
+     * @return: read_through[i] 为 true 表示第 i 个块之前的间隙连读通过，否则 Pass 通过
+     */
+    const std::vector<char>& plan(const std::vector<int>& offsets, int level) {
+        int k = std::min(static_cast<int>(offsets.size()), MAX_PLAN_BLOCKS);
+        const int INF = 1 << 30;
+        for (int i = 0; i <= k; i++)
+            std::fill(cost[i], cost[i] + LEVEL_NUM, INF);
+        cost[0][level] = 0;
+
+        int prev_offset = -1;
+        for (int i = 0; i < k; i++) {
+            int gap = offsets[i] - prev_offset - 1;
+            prev_offset = offsets[i];
+            for (int l = 0; l < LEVEL_NUM; l++) {
+                if (cost[i][l] == INF)
+                    continue;
+                // 连读通过间隙，再读该块；间隙为0时就是直接读
+                int c = cost[i][l], cur = l;
+                for (int j = 0; j < gap && cur < LEVEL_NUM - 1; j++) {
+                    c += read_cost_at(cur);
+                    cur = next_level(cur);
+                }
+                if (gap > 0 && cur == LEVEL_NUM - 1)
+                    c += read_cost_at(cur) * std::max(0, gap - (LEVEL_NUM - 1 - l));
+                c += read_cost_at(cur);
+                relax(i, l, next_level(cur), c, true);
+                // Pass 通过间隙，连读中断，再以 64 读该块
+                if (gap > 0)
+                    relax(i, l, next_level(0), cost[i][l] + gap + read_cost_at(0), false);
+            }
+        }
+
+        // 回溯最优方案
+        read_through.assign(k, 0);
+        int best = 0;
+        for (int l = 1; l < LEVEL_NUM; l++) {
+            if (cost[k][l] < cost[k][best])
+                best = l;
+        }
+        for (int i = k; i > 0; i--) {
+            read_through[i - 1] = choice_read[i][best];
+            best = parent[i][best];
+        }
+        return read_through;
+    }
+
+private:
+    int cost[MAX_PLAN_BLOCKS + 1][LEVEL_NUM];
+    int parent[MAX_PLAN_BLOCKS + 1][LEVEL_NUM];
+    char choice_read[MAX_PLAN_BLOCKS + 1][LEVEL_NUM];
+    std::vector<char> read_through;
+
+    void relax(int i, int from, int to, int c, bool read) {
+        if (c < cost[i + 1][to]) {
+            cost[i + 1][to] = c;
+            parent[i + 1][to] = from;
+            choice_read[i + 1][to] = read;
+        }
+    }
+};
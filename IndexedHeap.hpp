@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+// 可寻址的二叉堆，元素为 <key, id>，key 越大优先级越高，堆顶优先级最高
+// key 缓存在堆中，比较时不需要回查元素；支持按id删除和调整优先级
+// 每个元素在堆中的下标由调用方存储：position(id) 返回该下标的引用，-1 表示不在堆中，
+// 这样元素本身可以放在按id直接寻址的容器里，不需要额外的哈希索引
+template <typename Key, typename PositionOf>
+class IndexedHeap {
+private:
+    struct Entry {
+        Key key;
+        int id;
+    };
+    std::vector<Entry> heap;
+    PositionOf position;
+
+    void place(int index, const Entry& entry) {
+        heap[index] = entry;
+        position(entry.id) = index;
+    }
+
+    // 用“空穴”上浮/下沉，每层只移动一次元素
+    void sift_up(int index) {
+        Entry entry = heap[index];
+        while (index > 0) {
+            int parent = (index - 1) / 2;
+            if (!(heap[parent].key < entry.key))
+                break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, entry);
+    }
+
+    void sift_down(int index) {
+        Entry entry = heap[index];
+        int n = static_cast<int>(heap.size());
+        while (true) {
+            int child = 2 * index + 1;
+            if (child >= n)
+                break;
+            if (child + 1 < n && heap[child].key < heap[child + 1].key)
+                child++;
+            if (!(entry.key < heap[child].key))
+                break;
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, entry);
+    }
+
+    // 在下标 index 处的 key 改变后向上或向下调整
+    void restore(int index) {
+        if (index > 0 && heap[(index - 1) / 2].key < heap[index].key)
+            sift_up(index);
+        else
+            sift_down(index);
+    }
+
+    // 删除下标为 index 的元素，用末尾元素填补后向上或向下调整
+    void remove_at(int index) {
+        position(heap[index].id) = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (index == static_cast<int>(heap.size()))
+            return;
+        place(index, last);
+        restore(index);
+    }
+
+public:
+    explicit IndexedHeap(PositionOf position = PositionOf()) : position(std::move(position)) {}
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    int top() const {
+        return heap.front().id;
+    }
+
+    void push(int id, Key key) {
+        heap.push_back({key, id});
+        sift_up(static_cast<int>(heap.size()) - 1);
+    }
+
+    void pop() {
+        remove_at(0);
+    }
+
+    // 删除指定id，不在堆中时返回false
+    bool erase(int id) {
+        int index = position(id);
+        if (index == -1)
+            return false;
+        remove_at(index);
+        return true;
+    }
+
+    // id 的优先级改变（升高或降低）后调用，更新 key 并重新调整它在堆中的位置
+    void update(int id, Key key) {
+        int index = position(id);
+        if (index == -1)
+            return;
+        heap[index].key = key;
+        restore(index);
+    }
+};
@@ -1,12 +1,14 @@
-#include <vector>
+#pragma once
+
+#include <algorithm>
 
 #include "limit.h"
 
 // 记录备份信息
 struct Replica {
     int disk_id;    // 所在磁盘id
-    // ? 是否用Block类而不是int存储每个单独的内存块更好？
-    std::vector<int> units; // 存储单元位置数组
+    // 存储单元位置数组，units[0] 占位，units[1..size] 为每一块的位置；定长内联存储，不需要单独分配内存
+    int units[MAX_OBJ_SIZE + 1];
 };
 
 class Object {
@@ -25,8 +27,8 @@ public:
 
     Object(int id, int size, int tag) : id(id), size(size), tag(tag) {
         for (int i = 0; i < REP_NUM; ++i) {
-            replicas[i].units.clear();
-            replicas[i].units.reserve(size + 1);
+            replicas[i].disk_id = 0;
+            std::fill(replicas[i].units, replicas[i].units + MAX_OBJ_SIZE + 1, 0);
         }
         is_deleted = false;
     }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "Object.hpp"
+
+// 按对象id直接索引的对象表，代替 unordered_map<int, Object>
+// 对象id不超过 MAX_OBJECT_NUM，各字段分别存成连续数组（结构体数组转为数组结构体）：
+// 查找不需要哈希，写入和删除不分配内存，只访问大小或标签时也不会把副本信息读进缓存
+class ObjectTable {
+private:
+    std::vector<char> alive;    // 对象是否存在
+    std::vector<int> sizes;
+    std::vector<int> tags;
+    std::vector<Replica> replicas;  // replicas[id * REP_NUM + i] 为对象 id 的第 i 个副本
+    // pending[id * (MAX_OBJ_SIZE + 1) + b] 为还没读到对象 id 第 b 块的请求数，三个副本上的这一块共用一个计数
+    std::vector<int> pending;
+
+public:
+    ObjectTable(int capacity = MAX_OBJECT_NUM)
+        : alive(capacity, 0), sizes(capacity, 0), tags(capacity, 0), replicas(static_cast<size_t>(capacity) * REP_NUM),
+          pending(static_cast<size_t>(capacity) * (MAX_OBJ_SIZE + 1), 0) {}
+
+    bool contains(int id) const {
+        return id >= 0 && id < static_cast<int>(alive.size()) && alive[id];
+    }
+
+    int size(int id) const {
+        return sizes[id];
+    }
+
+    int tag(int id) const {
+        return tags[id];
+    }
+
+    Replica& replica(int id, int i) {
+        return replicas[static_cast<size_t>(id) * REP_NUM + i];
+    }
+
+    const Replica& replica(int id, int i) const {
+        return replicas[static_cast<size_t>(id) * REP_NUM + i];
+    }
+
+    int& pending_reads(int id, int block) {
+        return pending[static_cast<size_t>(id) * (MAX_OBJ_SIZE + 1) + block];
+    }
+
+    int pending_reads(int id, int block) const {
+        return pending[static_cast<size_t>(id) * (MAX_OBJ_SIZE + 1) + block];
+    }
+
+    void insert(const Object& obj) {
+        alive[obj.id] = 1;
+        sizes[obj.id] = obj.size;
+        tags[obj.id] = obj.tag;
+        for (int i = 0; i < REP_NUM; i++) {
+            replica(obj.id, i) = obj.replicas[i];
+        }
+        std::fill(&pending_reads(obj.id, 0), &pending_reads(obj.id, 0) + MAX_OBJ_SIZE + 1, 0);
+    }
+
+    void erase(int id) {
+        alive[id] = 0;
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// 磁盘存储单元的占用位图，第 unit 个存储单元对应第 unit-1 位，1 表示已使用
+// V=16384 时只占 2KB，查询按 64 位字并行处理：用 ctz 跳过整段已用/空闲的单元，用 popcount 计数
+class OccupancyBitmap {
+private:
+    int size = 0;   // 存储单元数
+    std::vector<uint64_t> words;
+
+    // [0, bit) 的掩码，bit 为 0~64
+    static uint64_t low_mask(int bit) {
+        return bit >= 64 ? ~0ULL : ((1ULL << bit) - 1);
+    }
+
+    // 返回 [from, size) 中第一个取值为 used 的位，没有则返回 size
+    int next_bit(int from, bool used) const {
+        if (from >= size)
+            return size;
+        int w = from >> 6;
+        uint64_t word = (used ? words[w] : ~words[w]) & ~low_mask(from & 63);
+        while (word == 0) {
+            if (++w >= static_cast<int>(words.size()))
+                return size;
+            word = used ? words[w] : ~words[w];
+        }
+        return std::min(size, (w << 6) + __builtin_ctzll(word));
+    }
+
+    // [from, to) 中第一段长度至少为 k 的空闲区间的起始位，没有则返回 -1
+    int find_run_in(int from, int to, int k) const {
+        while (from < to) {
+            int start = next_bit(from, false);
+            if (start >= to)
+                return -1;
+            int end = std::min(next_bit(start, true), to);
+            if (end - start >= k)
+                return start;
+            from = end;
+        }
+        return -1;
+    }
+
+    // [from, to) 中已使用的单元数
+    int count_used_in(int from, int to) const {
+        if (from >= to)
+            return 0;
+        int wf = from >> 6, wt = (to - 1) >> 6;
+        if (wf == wt)
+            return __builtin_popcountll(words[wf] & ~low_mask(from & 63) & low_mask(((to - 1) & 63) + 1));
+        int count = __builtin_popcountll(words[wf] & ~low_mask(from & 63));
+        for (int w = wf + 1; w < wt; ++w)
+            count += __builtin_popcountll(words[w]);
+        count += __builtin_popcountll(words[wt] & low_mask(((to - 1) & 63) + 1));
+        return count;
+    }
+
+    void assign(int unit, bool used) {
+        int bit = unit - 1;
+        if (used)
+            words[bit >> 6] |= 1ULL << (bit & 63);
+        else
+            words[bit >> 6] &= ~(1ULL << (bit & 63));
+    }
+
+public:
+    OccupancyBitmap() {}
+    OccupancyBitmap(int totalSize) : size(totalSize), words((totalSize + 63) / 64, 0) {}
+
+    // 标记一个对象副本占用的存储单元 units[1..n]（首元素占位）
+    void set_units(const int* units, int n) {
+        for (int i = 1; i <= n; ++i)
+            assign(units[i], true);
+    }
+
+    void clear_units(const int* units, int n) {
+        for (int i = 1; i <= n; ++i)
+            assign(units[i], false);
+    }
+
+    // 在 [first_unit, last_unit] 中按地址顺序查找第一段长度至少为 k 的连续空闲单元，不绕回
+    int find_free_run_in(int k, int first_unit, int last_unit) const {
+        int start = find_run_in(first_unit - 1, std::min(last_unit, size), k);
+        return start == -1 ? -1 : start + 1;
+    }
+
+    // 从 unit 开始、长度为 len 的窗口中空闲单元数，窗口超出 V 时绕回 1
+    int count_free(int unit, int len) const {
+        len = std::min(len, size);
+        int from = unit - 1, to = from + len;
+        int used = to <= size ? count_used_in(from, to) : count_used_in(from, size) + count_used_in(0, to - size);
+        return len - used;
+    }
+
+    int count_free() const {
+        return count_free(1, size);
+    }
+
+    // 空闲区间数：空闲且前一位已使用（或位于开头）的位的个数，衡量碎片化程度
+    int count_free_runs() const {
+        int runs = 0;
+        uint64_t prev_used = 1;  // 第 1 个单元之前视为已使用
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t free = ~words[w];
+            if (static_cast<int>(w) == static_cast<int>(words.size()) - 1)
+                free &= low_mask(size - (static_cast<int>(w) << 6));
+            uint64_t used_before = (words[w] << 1) | prev_used;
+            runs += __builtin_popcountll(free & used_before);
+            prev_used = words[w] >> 63;
+        }
+        return runs;
+    }
+};
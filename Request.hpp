@@ -1,3 +1,7 @@
+#include <algorithm>
+
+#include "limit.h"
+
 enum class Status {
     PENDING,    // 还没开始读的
     READING,    // 正在连续读的
@@ -11,23 +15,42 @@ public:
     Status status;  // 状态
 
     int start_timestamp;    // 请求到达的时间戳
-    // int deadline_timestamp;  // 最晚完成时间戳，超过没分
+    int deadline_timestamp;  // 最晚完成时间戳，到这个时间片还没上报就没分
     // int processed_units = 0; // 已处理单元数
     float priority;    // 优先级
-    int responsible_disk_id;    // 负责该请求的磁盘id，-1表示还没分配
+    int heap_index;    // 在请求队列（堆）中的下标，-1表示不在队列中
+    int object_size;    // 对象块数
+    // 每个块由哪个磁盘读取，0表示还没分配；同一对象的不同块可以分给不同副本所在的磁盘同时读
+    int block_disk[MAX_OBJ_SIZE + 1];
+    int read_mask;  // 第 i 位为1表示第 i 块已经从某个副本读到，所有块都读到时请求完成
+    int rejected_backlog;   // 被准入控制拒绝时所有磁盘的待读单元总数，积压降到这个值的一半以下才重新检查
 
     Request() {
         this->req_id = -1;
         this->status = Status::COMPLETED;
+        this->heap_index = -1;
+    }
+
+    bool is_assigned() const {
+        return status == Status::READING;
+    }
+
+    // 对象的每一块都已经读到
+    bool all_blocks_read() const {
+        return read_mask == ((1 << (object_size + 1)) - 2);
     }
 
-    Request(int req_id, int object_id, int start_timestamp) {
+    Request(int req_id, int object_id, int object_size, int start_timestamp) {
         this->req_id = req_id;
         this->object_id = object_id;
+        this->object_size = object_size;
         this->start_timestamp = start_timestamp;
-        // this->deadline_timestamp = start_timestamp + 105;
+        this->deadline_timestamp = start_timestamp + EXTRA_TIME;
         this->status = Status::PENDING;
-        this->responsible_disk_id = -1;
+        std::fill(this->block_disk, this->block_disk + MAX_OBJ_SIZE + 1, 0);
+        this->read_mask = 0;
+        this->rejected_backlog = -1;
         this->priority = 0;
+        this->heap_index = -1;
     }
 };
\ No newline at end of file
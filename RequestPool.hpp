@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "Request.hpp"
+
+// 按请求id直接寻址的请求池（环形缓冲区），代替 unordered_map<int, Request>
+// 请求id按到达顺序递增，还需要读取的请求都是最近 EXTRA_TIME 个时间片内到达的，
+// 它们的id落在连续窗口 [base_id, base_id + capacity) 中，槽位为 id & (capacity - 1)。
+// 窗口之前的请求已经完成、被取消或超时，槽位可以直接复用；窗口放不下时容量翻倍。
+// 插入和删除只是写一个槽位，不分配内存，也不会因为扩容重新哈希而卡顿
+class RequestPool {
+private:
+    std::vector<Request> slots;
+    int mask = 0;
+    int base_id = 0;    // 小于 base_id 的请求都已经不在池中
+
+    Request& slot(int id) {
+        return slots[id & mask];
+    }
+
+    // 容量翻倍直到能放下 [base_id, id]，把窗口内的请求搬到新位置
+    void grow(int id) {
+        int capacity = static_cast<int>(slots.size());
+        while (id - base_id >= capacity)
+            capacity *= 2;
+        std::vector<Request> old_slots(capacity);
+        old_slots.swap(slots);
+        mask = capacity - 1;
+        for (Request& req : old_slots) {
+            if (req.req_id >= base_id)
+                slot(req.req_id) = req;
+        }
+    }
+
+public:
+    // 堆中下标存放在请求记录里，供 IndexedHeap 使用
+    struct HeapPosition {
+        RequestPool* pool;
+        int& operator()(int id) const {
+            return pool->slot(id).heap_index;
+        }
+    };
+
+    explicit RequestPool(int capacity = 1 << 16) : slots(capacity), mask(capacity - 1) {}
+
+    // 请求不在池中时返回空指针
+    Request* find(int id) {
+        Request& req = slot(id);
+        return req.req_id == id ? &req : nullptr;
+    }
+
+    Request& operator[](int id) {
+        return slot(id);
+    }
+
+    Request& insert(const Request& req) {
+        if (req.req_id - base_id >= static_cast<int>(slots.size()))
+            grow(req.req_id);
+        Request& stored = slot(req.req_id);
+        stored = req;
+        return stored;
+    }
+
+    void erase(int id) {
+        Request& req = slot(id);
+        if (req.req_id == id)
+            req.req_id = -1;
+    }
+
+    // id 小于 first_live_id 的请求都已经移出请求池，窗口前移
+    void release_before(int first_live_id) {
+        if (first_live_id > base_id)
+            base_id = first_live_id;
+    }
+};
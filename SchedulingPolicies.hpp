@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+
+#include "limit.h"
+#include "Disk.hpp"
+
+// 调度策略，作为 BasicDiskScheduler 的模板参数
+// 权重都是编译期常量，打分函数在调用处完全内联；换一组策略就是换一个模板实参，
+// 可以在 tools/bench.cpp 中与默认策略并列构建对比，不需要虚函数或 std::function
+
+// 排队读请求的优先级，越大越先分配磁盘
+struct DefaultPriorityPolicy {
+    static constexpr float DISTANCE_WEIGHT = 0.4f;  // 三个副本的磁头到对象第一块的距离之和
+    static constexpr float HEAT_WEIGHT = 0.6f;      // 对象所属标签的当前热度
+    static constexpr float AGE_WEIGHT = 0.4f;       // 已等待时间，归一化到和距离同一量级
+    static constexpr float READING_PRIORITY = 10000000.0f;  // 正在读的请求
+    static constexpr float COMPLETED_PRIORITY = 0.0f;       // 已经完成的请求
+
+    /*
+     * @param distance: 三个副本所在磁盘的磁头到该对象第一个存储单元的距离之和
+     * @param heat: 标签热度
+     * @param age: 已等待的时间片数 / EXTRA_TIME，在 [0, 1] 之间
+     * @param disk_size: 磁盘大小，把 age 放大到和距离同一量级
+     */
+    static float score(float distance, float heat, float age, int disk_size) {
+        return distance * DISTANCE_WEIGHT + heat * HEAT_WEIGHT + age * REP_NUM * disk_size * AGE_WEIGHT;
+    }
+};
+
+// 写入时磁盘的得分，越高越适合
+struct DefaultDiskSelectionPolicy {
+    // 连续空间的权重为 CONTIGUOUS_WEIGHT + CONTIGUOUS_SIZE_WEIGHT * 对象大小 / MAX_OBJ_SIZE，其余为标签权重
+    static constexpr float CONTIGUOUS_WEIGHT = 0.7f;
+    static constexpr float CONTIGUOUS_SIZE_WEIGHT = 0.2f;
+    static constexpr float NO_CONTIGUOUS_PENALTY = 1.0f;    // 放不下整个对象时减去的分数
+    static constexpr int FULL_PERCENT = 90;                 // 已使用空间超过该百分比的磁盘不能选择
+    static constexpr float FULL_SCORE = -2.0f;
+    // 标签权重按标签的相对热度缩放：比平均冷的标签不太需要分散读取，更看重连续空间；热标签保持原权重
+    static constexpr float MIN_HEAT_SCALE = 0.8f;
+    static constexpr float MAX_HEAT_SCALE = 1.0f;
+
+    /*
+     * @param relative_heat: 标签当前热度 / 所有标签的平均热度
+     * @return: 已使用空间超过 FULL_PERCENT 时为 FULL_SCORE，放不下整个对象时再减 NO_CONTIGUOUS_PENALTY
+     */
+    static float score(const Disk& disk, int tag, int size, float relative_heat) {
+        // 对象越大，越需要有连续的空间可以存储该对象，否则每次读的耗时就越大
+        // 用 size_ratio 表示这个对象对连续空间的依赖程度
+        float size_ratio = (float)size / (float)MAX_OBJ_SIZE;
+        // 1. 足够存放的连续空间（70%~90%权重，减少碎片）
+        float contiguous_weight = CONTIGUOUS_WEIGHT + size_ratio * CONTIGUOUS_SIZE_WEIGHT;
+        // 2. 尽量选择与该对象同标签少的磁盘（10%~20%权重，再按相对热度缩放，平衡负载），有利于不同标签对象的并行读取
+        float tag_weight = (1.0f - contiguous_weight) * std::min(std::max(relative_heat, MIN_HEAT_SCALE), MAX_HEAT_SCALE);
+
+        int largest_free_block = disk.sfl.get_largest_free_block_size();
+        float contiguous_score = static_cast<float>(largest_free_block) / (float)MAX_OBJ_SIZE; // 归一化到[0,1]范围
+        float tag_score = 1.0f - (static_cast<float>(disk.tag_slot_num[tag]) / static_cast<float>(disk.size));
+        float total_score = (contiguous_score * contiguous_weight) + (tag_score * tag_weight);
+        // 放不下整个对象的磁盘只能拆开存放，之后每次读都要多次寻道，而且写入后没有办法再移动对象，
+        // 所以排在所有能连续存放的磁盘之后
+        if (largest_free_block < size)
+            total_score -= NO_CONTIGUOUS_PENALTY;
+        // 如果已使用空间超过 FULL_PERCENT，则不能选择该磁盘
+        // 用下面这种判断只是为了免去转换到float
+        if (disk.used_units * 100 > FULL_PERCENT * disk.size)
+            total_score = FULL_SCORE;
+        return total_score;
+    }
+};
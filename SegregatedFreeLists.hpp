@@ -1,9 +1,12 @@
+#pragma once
+
 #include <iostream>
 #include <list>
 #include <vector>
 #include <utility>
 
 #include "limit.h"
+#include "FitPolicy.hpp"
 
 // 表示一个空闲的磁盘块（区间）
 struct Block {
@@ -18,8 +21,9 @@ struct Block {
     }
 };
 
-// 分离空闲链表管理器
-class SegregatedFreeList {
+// 分离空闲链表管理器，FitPolicy 决定连续分配时选择哪个空闲块
+template <typename FitPolicy = WorstFit>
+class BasicSegregatedFreeList {
 private:
     // buckets[i-1] 管理大小为 i 的空闲块（1 <= i <= 5）
     // buckets[5] 用于管理超过 5 的大块空闲空间
@@ -27,18 +31,21 @@ private:
 
     /*
      * 尝试分配连续的 size 大小的内存块
-     * 采用Worst-Fit策略
+     * 按 FitPolicy 从大到小（Worst-Fit）或从小到大（Best-Fit）查找能放下的桶
      * @param size: 要分配的内存块大小
-     * @return: 分配成功返回一个被分配地址的 vector，否则返回空 vector
+     * @param units: 分配成功时写入 units[1..requestSize]
+     * @return: 是否分配成功
     */
-    std::vector<int> allocate_contiguous(int requestSize) {
-        for (int i = MAX_OBJ_SIZE; i >= requestSize - 1; --i) {
+    bool allocate_contiguous(int requestSize, int* units) {
+        for (int k = 0; k <= MAX_OBJ_SIZE - (requestSize - 1); ++k) {
+            int i = FitPolicy::LARGEST_FIRST ? MAX_OBJ_SIZE - k : requestSize - 1 + k;
             std::list<Block>& bucket = buckets[i];
             if (!bucket.empty()) {
                 std::list<Block>::iterator best_it;
                 if (i == MAX_OBJ_SIZE) {
-                    best_it = std::max_element(bucket.begin(), bucket.end(), 
-                        [](const Block& a, const Block& b){ return a.size < b.size; });
+                    auto by_size = [](const Block& a, const Block& b){ return a.size < b.size; };
+                    best_it = FitPolicy::LARGEST_FIRST ? std::max_element(bucket.begin(), bucket.end(), by_size)
+                                                       : std::min_element(bucket.begin(), bucket.end(), by_size);
                 }
                 else {
                     best_it = bucket.begin();
@@ -54,28 +61,25 @@ private:
                     buckets[bucketIdx].emplace_back(block.start + requestSize, remaining);
                 }
     
-                std::vector<int> units(requestSize + 1);
                 for (int i = 1; i <= requestSize; ++i) {
                     units[i] = block.start + i - 1;
                 }
 
-                return units;
+                return true;
             }
         }
-        return {};
+        return false;
     }
 
     /*
      * 尝试分配不连续的 size 大小的内存块
      * 采用Worst-Fit策略
      * @param size: 要分配的内存块大小
-     * @return: 分配成功返回一个地址升序的被分配地址 vector，否则返回空 vector
+     * @param units: 分配成功时按地址升序写入 units[1..requestSize]
+     * @return: 是否分配成功
     */
-    std::vector<int> allocate_noncontiguous(int requestSize) {
-        std::vector<int> units;
-        units.reserve(requestSize + 1); // 提前预留空间，省去扩容耗时
-        units.emplace_back(0); // 首元素占位
-        
+    bool allocate_noncontiguous(int requestSize, int* units) {
+
         // 生成可能的分割组合（按从大到小排序）,<int,int>表示<分割大小,分割数量>
         // 例如requestSize=5时，partitions={{[4,1],[1,1]}, {[3,1],[2,1]}, {[2,2],[1,1]}, {[1,5]}}
         std::vector<std::unordered_map<int, int>> partitions;
@@ -100,8 +104,8 @@ private:
             
             // 注意，调用非连续分配方法时，已经没有buckets[MAX_OBJ_SIZE]了
             // 尝试分配每个部分
-            for (const std::pair<int, int>& part : partation) {
-                if (buckets[part.first - 1].size() < part.second) {
+            for (const auto& part : partation) {
+                if (static_cast<int>(buckets[part.first - 1].size()) < part.second) {
                     success = false;
                     break;
                 }
@@ -109,21 +113,21 @@ private:
             
             // 按照该方案进行分配
             if (success) {
-                for (const std::pair<int, int>& part : partation) {
+                int filled = 0;
+                for (const auto& part : partation) {
                     for (int i = 0; i < part.second; ++i) {
-                        std::vector<int> allocated = allocate_contiguous(part.first);
-                        for (int j = 1; j < allocated.size(); ++j) {
-                            units.emplace_back(allocated[j]);
-                        }
+                        // 每一部分接在已分配的单元后面
+                        allocate_contiguous(part.first, units + filled);
+                        filled += part.first;
                     }
                 }
 
                 // 按物理地址排序（提升读取效率）
-                std::sort(units.begin() + 1, units.end());
-                return units;
+                std::sort(units + 1, units + requestSize + 1);
+                return true;
             }
         }
-        return {};
+        return false;
     }
 
     // 用于合并新释放的块 newBlock 与相邻的空闲块（如果存在）
@@ -133,7 +137,7 @@ private:
         while (merged) {
             merged = false;
             // 遍历所有桶
-            for (int b = 0; b < buckets.size(); ++b) {
+            for (int b = 0; b < static_cast<int>(buckets.size()); ++b) {
                 auto it = buckets[b].begin();
                 while (it != buckets[b].end()) {
                     // 若该空闲块在 newBlock 之前且正好相邻
@@ -163,40 +167,58 @@ private:
     }
 
 public:
-    SegregatedFreeList() : buckets(MAX_OBJ_SIZE + 1) {}
+    BasicSegregatedFreeList() : buckets(MAX_OBJ_SIZE + 1) {}
     // 初始化时整个磁盘内存从 1 到 totalSize 为连续空闲区域
     // TODO: 考虑有没有更好的初始化方法，例如为预处理得知的读取较多的对象预先分配专属的空间区域
-    SegregatedFreeList(int totalSize) : buckets(MAX_OBJ_SIZE + 1) {
+    BasicSegregatedFreeList(int totalSize) : buckets(MAX_OBJ_SIZE + 1) {
         buckets[MAX_OBJ_SIZE].emplace_back(1, totalSize);
     }
     
-    // 分配 requestSize 大小的内存块
-    // 返回分配的内存块，如果分配失败返回空数组
-    std::vector<int> allocate(int requestSize) {
-        std::vector<int> allocated = allocate_contiguous(requestSize);
+    // 分配 requestSize 大小的内存块，写入 units[1..requestSize]
+    // 分配失败返回false
+    bool allocate(int requestSize, int* units) {
         // 优先尝试分配连续空间
-        if (allocated.size() > 1) {
-            return allocated;
+        if (allocate_contiguous(requestSize, units)) {
+            return true;
         }
         else {
-            allocated = allocate_noncontiguous(requestSize);
-            if (allocated.size() > 1) {
-                return allocated;
-            }
-            else {
-                return {};
+            return allocate_noncontiguous(requestSize, units);
+        }
+    }
+
+    // 分配从 start 开始的 size 个连续单元，这段空间必须完全空闲，输出格式与 allocate 相同
+    // 需要遍历所有桶找到包含 start 的空闲块
+    bool allocate_range(int start, int size, int* units) {
+        for (int b = 0; b < static_cast<int>(buckets.size()); ++b) {
+            for (auto it = buckets[b].begin(); it != buckets[b].end(); ++it) {
+                if (it->start > start || it->end() <= start)
+                    continue;
+                Block block = *it;
+                if (start + size > block.end())
+                    return false;
+                buckets[b].erase(it);
+                if (block.start < start)
+                    mergeAndInsert(Block(block.start, start - block.start));
+                if (start + size < block.end())
+                    mergeAndInsert(Block(start + size, block.end() - start - size));
+
+                for (int i = 1; i <= size; ++i) {
+                    units[i] = start + i - 1;
+                }
+                return true;
             }
         }
+        return false;
     }
 
-    // 释放磁盘块，将其归还到对应的空闲链表中
-    void freeBlock(const std::vector<int>& allocated_units) {
+    // 释放磁盘块 allocated_units[1..size]，将其归还到对应的空闲链表中
+    void freeBlock(const int* allocated_units, int size) {
         // 将分散的存储单元转换为连续块（默认已排序）
         std::vector<Block> to_free;
         int current_start = allocated_units[1]; // 跳过首元素
         int current_size = 1;
         
-        for (int i = 2; i < allocated_units.size(); ++i) {
+        for (int i = 2; i <= size; ++i) {
             if (allocated_units[i] == allocated_units[i-1] + 1) {
                 current_size++;
             } else {
@@ -213,8 +235,8 @@ public:
         }
     }
 
-    // 返回最大的空闲块size
-    int get_largest_free_block_size() {
+    // 返回最大的空闲块size，没有空闲块时为 0，与 ExtentFreeList 一致
+    int get_largest_free_block_size() const {
         if (!buckets[4].empty() || !buckets[5].empty()) {
             return 5;
         }
@@ -227,8 +249,13 @@ public:
         else if (!buckets[1].empty()) {
             return 2;
         }
-        else {
+        else if (!buckets[0].empty()) {
             return 1;
         }
+        else {
+            return 0;
+        }
     }
 };
+
+using SegregatedFreeList = BasicSegregatedFreeList<WorstFit>;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "limit.h"
+
+// 在线的标签热度估计
+// 预处理的 tag_info 只给出每个 epoch（1800 个时间片）的总量，实际负载在 epoch 内会漂移。
+// 这里对每个标签维护按指数衰减的读、删块数（半衰期 HEAT_HALF_LIFE 个时间片），
+// 换算成与预测热度相同的口径（WINDOW_SIZE 个 epoch 内读块数 / (删块数 + 1)）后与预测值混合。
+// 每个读请求、删除只更新一个标签的计数，每个时间片衰减一次所有标签，任何时间片都可以 O(1) 查询
+class TagHeatEstimator {
+private:
+    std::vector<double> read_rate;      // 每个标签衰减后的读块数
+    std::vector<double> delete_rate;    // 每个标签衰减后的删块数
+    std::vector<float> forecast;        // 当前 epoch 的预测热度
+    std::vector<float> heat;            // 混合后的热度，读取时直接返回
+    double decay;       // 每个时间片的衰减系数
+    double rate_scale;  // 衰减计数换算成 WINDOW_SIZE 个 epoch 内的块数
+    int timestamp = 0;
+
+    void refresh(int tag) {
+        double observed = read_rate[tag] * rate_scale / (delete_rate[tag] * rate_scale + 1.0);
+        heat[tag] = static_cast<float>(HEAT_FORECAST_WEIGHT * forecast[tag] + (1.0 - HEAT_FORECAST_WEIGHT) * observed);
+    }
+
+public:
+    TagHeatEstimator() : decay(1.0), rate_scale(0.0) {}
+
+    explicit TagHeatEstimator(int num_tags)
+        : read_rate(num_tags + 1, 0.0), delete_rate(num_tags + 1, 0.0), forecast(num_tags + 1, 0.0f), heat(num_tags + 1, 0.0f)
+    {
+        decay = std::pow(0.5, 1.0 / HEAT_HALF_LIFE);
+        // 稳定时衰减计数约等于 每个时间片的块数 / (1 - decay)
+        rate_scale = (1.0 - decay) * FRE_PER_SLICING * WINDOW_SIZE;
+    }
+
+    // epoch 开始时更新预测热度
+    void set_forecast(int tag, float value) {
+        forecast[tag] = value;
+        refresh(tag);
+    }
+
+    // 每个时间片开始时调用一次，衰减所有标签的计数
+    void advance(int t) {
+        if (t <= timestamp)
+            return;
+        double factor = std::pow(decay, t - timestamp);
+        timestamp = t;
+        for (size_t tag = 1; tag < heat.size(); tag++) {
+            read_rate[tag] *= factor;
+            delete_rate[tag] *= factor;
+            refresh(static_cast<int>(tag));
+        }
+    }
+
+    void on_read(int tag, int blocks) {
+        read_rate[tag] += blocks;
+        refresh(tag);
+    }
+
+    void on_delete(int tag, int blocks) {
+        delete_rate[tag] += blocks;
+        refresh(tag);
+    }
+
+    float get(int tag) const {
+        return heat[tag];
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// 可选的运行统计，编译时定义 ENABLE_TELEMETRY 才启用（cmake -DENABLE_TELEMETRY=ON），否则所有调用都是空函数
+// 每个时间片写一条二进制记录到环境变量 TELEMETRY_FILE 指定的文件，没有指定时写到 stderr，不会影响 stdout 上的交互协议
+// 文件格式（小端）：文件头 TelemetryHeader，之后每个时间片依次为
+//   SliceTelemetry，num_disks 个 DiskTelemetry（1 号磁盘在前），latency_count 个 uint8（本时间片完成的请求的延迟）
+// 用 tools/telemetry_summary.py 汇总
+
+#pragma pack(push, 1)
+struct TelemetryHeader {
+    char magic[4];      // "CCTM"
+    int32_t version;
+    int32_t num_disks;
+    int32_t G;
+};
+
+// 一个时间片的请求统计
+struct SliceTelemetry {
+    int32_t timestamp;
+    int32_t arrived;        // 到达的读请求数
+    int32_t started;        // 开始分配给磁盘读取的请求数
+    int32_t completed;      // 完成的请求数
+    int32_t aborted;        // 对象被删除而取消的请求数
+    int32_t expired;        // 超过 EXTRA_TIME 不再读取的请求数
+    int32_t backlog;        // 时间片结束时还没完成的请求数：排队的请求 + 每个磁盘上分配给它、还没完成的请求（跨多个磁盘的请求分别计数）
+    int32_t latency_count;  // 后面跟着的延迟个数，等于 completed
+};
+
+// 一个磁盘在一个时间片内的令牌去向和空间状态
+struct DiskTelemetry {
+    uint16_t pass_tokens;
+    uint16_t read_tokens;
+    uint16_t jump_tokens;
+    uint16_t idle_tokens;   // 没有用掉的令牌
+    int32_t pending_units;  // 时间片结束时的待读块数
+    int32_t free_units;
+    int32_t free_runs;      // 空闲区间数，衡量碎片化程度
+};
+#pragma pack(pop)
+
+#ifdef ENABLE_TELEMETRY
+
+class Telemetry {
+public:
+    static constexpr bool ENABLED = true;
+
+    Telemetry() {}
+
+    ~Telemetry() {
+        if (out == nullptr)
+            return;
+        if (out == stderr)
+            fflush(out);
+        else
+            fclose(out);
+    }
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    void open(int num_disks, int G) {
+        const char* path = getenv("TELEMETRY_FILE");
+        out = path != nullptr ? fopen(path, "wb") : nullptr;
+        if (out == nullptr)
+            out = stderr;
+        TelemetryHeader header = {{'C', 'C', 'T', 'M'}, 1, num_disks, G};
+        fwrite(&header, sizeof(header), 1, out);
+        this->G = G;
+        disks.assign(num_disks + 1, DiskTelemetry());
+    }
+
+    // 磁头线程只修改自己磁盘的记录
+    DiskTelemetry& disk(int disk_id) {
+        return disks[disk_id];
+    }
+
+    void on_arrive() {
+        slice.arrived++;
+    }
+
+    void on_start() {
+        slice.started++;
+    }
+
+    void on_complete(int latency) {
+        slice.completed++;
+        latencies.push_back(static_cast<uint8_t>(latency));
+    }
+
+    void on_abort(int n) {
+        slice.aborted += n;
+    }
+
+    void on_expire(int n) {
+        slice.expired += n;
+    }
+
+    // 写出本时间片的记录并清零，磁盘的空间状态由调用方填好
+    void end_slice(int timestamp, int backlog) {
+        slice.timestamp = timestamp;
+        slice.backlog = backlog;
+        slice.latency_count = static_cast<int32_t>(latencies.size());
+        fwrite(&slice, sizeof(slice), 1, out);
+        for (size_t i = 1; i < disks.size(); i++) {
+            DiskTelemetry& d = disks[i];
+            d.idle_tokens = static_cast<uint16_t>(G - d.pass_tokens - d.read_tokens - d.jump_tokens);
+            fwrite(&d, sizeof(d), 1, out);
+            d = DiskTelemetry();
+        }
+        if (!latencies.empty())
+            fwrite(latencies.data(), 1, latencies.size(), out);
+        slice = SliceTelemetry();
+        latencies.clear();
+    }
+
+private:
+    FILE* out = nullptr;
+    int G = 0;
+    SliceTelemetry slice = SliceTelemetry();
+    std::vector<DiskTelemetry> disks;
+    std::vector<uint8_t> latencies;
+};
+
+#else
+
+// 关闭时的空实现，接口相同，调用处用 Telemetry::ENABLED 判断的代码也会被编译器去掉
+class Telemetry {
+public:
+    static constexpr bool ENABLED = false;
+
+    void open(int, int) {}
+    DiskTelemetry& disk(int) {
+        static DiskTelemetry unused;
+        return unused;
+    }
+    void on_arrive() {}
+    void on_start() {}
+    void on_complete(int) {}
+    void on_abort(int) {}
+    void on_expire(int) {}
+    void end_slice(int, int) {}
+};
+
+#endif
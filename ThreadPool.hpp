@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻线程池：线程在构造时创建，之后每个时间片复用，避免反复创建线程
+// run(n, task) 把 task(0) ... task(n-1) 分给工作线程和调用线程执行，全部完成后返回
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+
+    const std::function<void(int)>* current_task = nullptr;
+    int task_count = 0;
+    std::atomic<int> next_index{0};
+    int running_workers = 0;    // 本轮还没结束的工作线程数
+    long long generation = 0;   // 每调用一次 run 加一，唤醒工作线程
+    bool stopping = false;
+
+    // 领取并执行任务，直到本轮任务被领完
+    void drain() {
+        int index;
+        while ((index = next_index.fetch_add(1)) < task_count) {
+            (*current_task)(index);
+        }
+    }
+
+    void worker_loop() {
+        long long seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+                if (stopping)
+                    return;
+                seen_generation = generation;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--running_workers == 0)
+                    done_cv.notify_one();
+            }
+        }
+    }
+
+public:
+    // num_threads 为包括调用线程在内的线程数
+    explicit ThreadPool(int num_threads) {
+        for (int i = 1; i < num_threads; ++i) {
+            workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start_cv.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void run(int n, const std::function<void(int)>& task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current_task = &task;
+            task_count = n;
+            next_index = 0;
+            running_workers = static_cast<int>(workers.size());
+            ++generation;
+        }
+        start_cv.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&] { return running_workers == 0; });
+    }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 判题输入的二进制记录格式，全部是 int32（小端）：
+//   文件头：'CCTR' 版本号 T M N V G，之后是 tag_info 的删除、写入、读取三段，每段 M * epoch数 个整数（同输入顺序）
+//   每个时间片：timestamp
+//              n_delete, n_delete 个对象id
+//              n_write, n_write 组 <对象id, 大小, 标签>
+//              n_read, n_read 组 <请求id, 对象id>
+// 记录：运行 code_craft 时设置环境变量 RECORD_FILE，收到的输入会同时写入该文件
+// 回放：tools/replay.cpp 用 mmap 读取记录，直接驱动 DiskScheduler，不经过文本协议
+
+static const char TRACE_MAGIC[4] = {'C', 'C', 'T', 'R'};
+static const int32_t TRACE_VERSION = 1;
+
+// 把收到的输入按上面的格式写入文件，没有打开文件时所有调用都直接返回
+class TraceRecorder {
+private:
+    FILE* out = nullptr;
+    std::vector<int32_t> buffer;    // 当前时间片的记录，时间片结束时一次写出
+
+public:
+    TraceRecorder() {}
+
+    ~TraceRecorder() {
+        if (out != nullptr)
+            fclose(out);
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    bool open(const char* path) {
+        out = fopen(path, "wb");
+        if (out == nullptr)
+            return false;
+        fwrite(TRACE_MAGIC, 1, 4, out);
+        fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1, out);
+        return true;
+    }
+
+    bool recording() const {
+        return out != nullptr;
+    }
+
+    void write_int(int x) {
+        if (out != nullptr)
+            buffer.push_back(x);
+    }
+
+    void flush() {
+        if (out == nullptr || buffer.empty())
+            return;
+        fwrite(buffer.data(), sizeof(int32_t), buffer.size(), out);
+        buffer.clear();
+    }
+};
+
+// 用 mmap 映射记录文件，按顺序读出整数
+class TraceReplayer {
+private:
+    const int32_t* data = nullptr;
+    size_t count = 0;   // 整数个数
+    size_t pos = 0;
+    size_t mapped_size = 0;
+
+public:
+    TraceReplayer() {}
+
+    ~TraceReplayer() {
+        if (data != nullptr)
+            munmap(const_cast<int32_t*>(data), mapped_size);
+    }
+
+    TraceReplayer(const TraceReplayer&) = delete;
+    TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+    // 映射文件并检查文件头，失败返回false
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd == -1)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == -1 || st.st_size < 8) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        data = static_cast<const int32_t*>(p);
+        mapped_size = st.st_size;
+        count = mapped_size / sizeof(int32_t);
+        const char* magic = static_cast<const char*>(p);
+        if (magic[0] != TRACE_MAGIC[0] || magic[1] != TRACE_MAGIC[1] || magic[2] != TRACE_MAGIC[2] || magic[3] != TRACE_MAGIC[3]
+            || data[1] != TRACE_VERSION)
+            return false;
+        pos = 2;
+        return true;
+    }
+
+    bool finished() const {
+        return pos >= count;
+    }
+
+    int read_int() {
+        return pos < count ? data[pos++] : 0;
+    }
+
+    // 直接返回接下来 n 个整数的指针，不拷贝
+    const int32_t* read_ints(int n) {
+        if (n < 0 || pos + n > count) {
+            pos = count;
+            return nullptr;
+        }
+        const int32_t* p = data + pos;
+        pos += n;
+        return p;
+    }
+};
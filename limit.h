@@ -6,4 +6,11 @@
 #define FRE_PER_SLICING (1800)
 #define EXTRA_TIME (105)
 #define MAX_OBJ_SIZE (5)
-#define WINDOW_SIZE (2)
\ No newline at end of file
+#define WINDOW_SIZE (2)
+#define LOOKAHEAD_SLICES (2)    // 磁头规划向前看的时间片数
+#define READ_THREADS (1)    // 读阶段移动磁头的线程数，1 表示串行
+#define SPLIT_READ_PENALTY (64)    // 对象相邻两块由不同磁盘读取时的额外代价，换磁盘要重新从64个令牌开始连读
+#define HEAT_HALF_LIFE (300)    // 在线标签热度的半衰期（时间片）
+#define HEAT_FORECAST_WEIGHT (0.5)  // 标签热度中预处理预测值的权重，其余为在线观测值
+#define BATCH_LOAD_WEIGHT (0.02)  // 批量写入时，本批已写入某磁盘的块数占比对该磁盘得分的惩罚权重
+#define ADMISSION_READ_TOKENS (48)  // 准入控制估计磁头读完一个待读块的平均令牌数
@@ -3,111 +3,132 @@
 #include <cstdlib>
 
 #include "DiskScheduler.hpp"
+#include "FastIO.hpp"
+#include "TraceFile.hpp"
 
 // 时间片，对象标签数，磁盘数，存储单元数，每个磁头最多消耗的令牌数
 int T, M, N, V, G;
 
-void timestamp_action() {
-    int timestamp;
-    // %*s 跳过TIMESTAMP
-    scanf("%*s%d", &timestamp);
-    printf("TIMESTAMP %d\n", timestamp);
+// 交互协议的输入输出，每个阶段结束时 flush 一次
+FastReader in;
+FastWriter out;
+// 设置环境变量 RECORD_FILE 时，把收到的输入记录成二进制文件，用 tools/replay.cpp 回放
+TraceRecorder recorder;
 
-    fflush(stdout);
+void timestamp_action() {
+    // 跳过TIMESTAMP
+    in.skip_token();
+    int timestamp = in.read_int();
+    recorder.write_int(timestamp);
+    out.write_str("TIMESTAMP ", 10);
+    out.write_int(timestamp);
+    out.write_char('\n');
+
+    out.flush();
 }
 
 void delete_action(DiskScheduler& diskScheduler) {
-    int n_delete;
-    scanf("%d", &n_delete);
+    int n_delete = in.read_int();
     std::vector<int> delete_object_ids(n_delete);
-    std::vector<int> aborted_requests_ids;
+    recorder.write_int(n_delete);
     for (int i = 0; i < n_delete; i++) {
-        scanf("%d", &delete_object_ids[i]);
+        delete_object_ids[i] = in.read_int();
+        recorder.write_int(delete_object_ids[i]);
     }
 
-    for (int i = 0; i < n_delete; i++) {
-        int object_id = delete_object_ids[i];
-        std::vector<int> deleted_request_ids = diskScheduler.delete_object(object_id);
-        if (!deleted_request_ids.empty()) {
-            for (int deleted_request_id : deleted_request_ids) {
-                aborted_requests_ids.emplace_back(deleted_request_id);
-            }
-        }
-    }
+    // 整个时间片的删除一次性交给调度器处理
+    std::vector<int> aborted_requests_ids = diskScheduler.delete_objects(delete_object_ids);
 
-    printf("%d\n", aborted_requests_ids.size());
+    out.write_int(static_cast<int>(aborted_requests_ids.size()));
+    out.write_char('\n');
     for (int id : aborted_requests_ids) {
-        printf("%d\n", id);
+        out.write_int(id);
+        out.write_char('\n');
     }
 
-    fflush(stdout);
+    out.flush();
 }
 
-void write_action(DiskScheduler& diskScheduler, int timestamp)
+void write_action(DiskScheduler& diskScheduler)
 {
-    int n_write;
-    scanf("%d", &n_write);
-    int epoch = (timestamp - 1) / FRE_PER_SLICING;
-    // 优先分配标签热度高的，一样高时优先分配大小大的对象
-    auto comp = [epoch, &diskScheduler](const Object& a, const Object& b) {
-        float a_heat = diskScheduler.get_heat(a.tag, epoch), b_heat = diskScheduler.get_heat(b.tag, epoch);
-        if (a_heat != b_heat)
-            return a_heat < b_heat;
-        else
-            return a.size < b.size;
-        };
-    std::priority_queue<Object, std::vector<Object>, decltype(comp)> objects_to_be_written(comp);
-
+    int n_write = in.read_int();
+    recorder.write_int(n_write);
+    std::vector<Object> objects;
+    objects.reserve(n_write);
     for (int i = 1; i <= n_write; i++) {
-        int id, size, tag;
-        scanf("%d%d%d", &id, &size, &tag);
-        Object obj = Object(id, size, tag);
-        objects_to_be_written.emplace(obj);
+        int id = in.read_int();
+        int size = in.read_int();
+        int tag = in.read_int();
+        recorder.write_int(id);
+        recorder.write_int(size);
+        recorder.write_int(tag);
+        objects.emplace_back(id, size, tag);
     }
-    while (!objects_to_be_written.empty()) {
-        Object obj = objects_to_be_written.top();
-        diskScheduler.write_object(obj);
-        printf("%d\n", obj.id);
+    // 优先分配标签热度高的，一样高时优先分配大小大的对象，objects 按写入顺序返回
+    diskScheduler.write_objects(objects);
+    for (const Object& obj : objects) {
+        out.write_int(obj.id);
+        out.write_char('\n');
         for (int j = 0; j < REP_NUM; j++) {
-            printf("%d ", obj.replicas[j].disk_id);
-            std::vector<int>& units = obj.replicas[j].units;
+            out.write_int(obj.replicas[j].disk_id);
+            const int* units = obj.replicas[j].units;
             for (int i = 1; i <= obj.size; i++) {
-                printf("%d ", units[i]);
+                out.write_char(' ');
+                out.write_int(units[i]);
             }
-            printf("\n");
+            out.write_char('\n');
         }
-        objects_to_be_written.pop();
     }
 
-    fflush(stdout);
+    out.flush();
 }
 
 void read_action(DiskScheduler& diskScheduler, int timestamp) {
-    int n_read;
-    scanf("%d", &n_read);
-    int request_id, object_id;
-    std::vector<std::string> points_action(N + 1); // 每个磁头的动作
-    for (auto& s : points_action) s.clear();
-    std::vector<int> completed_requests; // 可以上报的请求
+    // 跨时间片复用，clear 不释放容量，稳定后不再分配内存
+    static std::vector<std::string> points_action(N + 1); // 每个磁头的动作
+    static std::vector<int> completed_requests; // 可以上报的请求
+    completed_requests.clear();
+
+    int n_read = in.read_int();
+    recorder.write_int(n_read);
     for (int i = 0; i < n_read; i++) {
-        scanf("%d%d", &request_id, &object_id);
+        int request_id = in.read_int();
+        int object_id = in.read_int();
+        recorder.write_int(request_id);
+        recorder.write_int(object_id);
         diskScheduler.add_request(request_id, object_id, timestamp);
     }
+    recorder.flush();
     diskScheduler.read_one_timeslice(points_action, completed_requests);
     for (int i = 1; i <= N; i++) {
-        printf("%s\n", points_action[i].c_str());
+        out.write_str(points_action[i]);
+        out.write_char('\n');
     }
-    printf("%d\n", completed_requests.size());
+    out.write_int(static_cast<int>(completed_requests.size()));
+    out.write_char('\n');
     for (int id : completed_requests) {
-        printf("%d\n", id);
+        out.write_int(id);
+        out.write_char('\n');
     }
 
-    fflush(stdout);
+    out.flush();
 }
 
 
 int main() {
-    scanf("%d%d%d%d%d", &T, &M, &N, &V, &G);
+    T = in.read_int();
+    M = in.read_int();
+    N = in.read_int();
+    V = in.read_int();
+    G = in.read_int();
+    const char* record_path = getenv("RECORD_FILE");
+    if (record_path != nullptr && !recorder.open(record_path))
+        fprintf(stderr, "fail to open %s\n", record_path);
+    recorder.write_int(T);
+    recorder.write_int(M);
+    recorder.write_int(N);
+    recorder.write_int(V);
+    recorder.write_int(G);
     // (T - 1) / FRE_PER_SLICING + 1 等价于 ceil(T / 1800)
     int n_epoch = (T - 1) / FRE_PER_SLICING + 1;    // 每1800时间片一个epoch
     // 用一个三维数组tag_info[tag][epoch][删/写/读]存储每个标签在每个epoch（从0开始）中删除、写入、读取的对象块数量
@@ -118,36 +139,43 @@ int main() {
     // 读取每个标签分别删除了几个对象块
     for (int i = 1; i <= M; i++) {
         for (int j = 1; j <= n_epoch; j++) {
-            scanf("%d", &tag_info[i][j][0]);
+            tag_info[i][j][0] = in.read_int();
+            recorder.write_int(tag_info[i][j][0]);
         }
     }
     // 读取每个标签分别写了几个对象块
     for (int i = 1; i <= M; i++) {
         for (int j = 1; j <= n_epoch; j++) {
-            scanf("%d", &tag_info[i][j][1]);
+            tag_info[i][j][1] = in.read_int();
+            recorder.write_int(tag_info[i][j][1]);
         }
     }
     // 读取每个标签分别读了几个对象块
     for (int i = 1; i <= M; i++) {
         for (int j = 1; j <= n_epoch; j++) {
-            scanf("%d", &tag_info[i][j][2]);
+            tag_info[i][j][2] = in.read_int();
+            recorder.write_int(tag_info[i][j][2]);
         }
     }
 
-    printf("OK\n");
-    fflush(stdout);
+    recorder.flush();
+    out.write_str("OK\n", 3);
+    out.flush();
 
     // 磁盘调度器，用于控制读写删操作
     DiskScheduler diskScheduler = DiskScheduler(M, N, V, G, tag_info, tag_heat);
+    diskScheduler.set_read_threads(READ_THREADS);
 
     for (int t = 1; t <= T + EXTRA_TIME; t++) {
         // 每个epoch更新一次标签热度
         if ((t - 1) % FRE_PER_SLICING == 0) {
             diskScheduler.update_tag_heat((t - 1) / FRE_PER_SLICING + 1);
         }
+        // 超时的请求不再读取，其余请求随年龄重新计算优先级
+        diskScheduler.age_requests(t);
         timestamp_action();
         delete_action(diskScheduler);
-        write_action(diskScheduler, t);
+        write_action(diskScheduler);
         read_action(diskScheduler, t);
     }
 
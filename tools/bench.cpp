@@ -0,0 +1,335 @@
+// 热点路径的微基准：空闲空间分配/释放、整批写入对象、删除对象、读一个时间片
+// 每项输出每次操作的耗时（ns/op）和内存分配次数（allocs/op），修改调度器后先跑一遍，不用等完整评测就能发现退化。
+//
+// 用法：./bench [名称过滤]，例如 ./bench alloc 只跑名称包含 alloc 的基准
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DiskScheduler.hpp"
+
+namespace {
+
+std::atomic<long long> allocation_count{0};
+
+// 所有替换的 operator new 都经过这里计数；超过默认对齐的用 aligned_alloc，两者都由 free 释放
+void* counted_alloc(size_t size, size_t alignment) noexcept {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+    if (alignment <= alignof(std::max_align_t))
+        return std::malloc(size);
+    // aligned_alloc 要求大小是对齐的整数倍
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* counted_alloc_or_throw(size_t size, size_t alignment) {
+    if (void* p = counted_alloc(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void counted_free(void* p) noexcept {
+    std::free(p);
+}
+
+}  // namespace
+
+// 统计全局 operator new 的调用次数，替换全部标量/数组、nothrow、对齐版本，对应的 operator delete 也全部替换
+void* operator new(size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new[](size_t size) { return counted_alloc_or_throw(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new(size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int V = 16384;
+const int M = 16;
+const int T = 86400;
+
+// 计时区间：只统计 start() 和 stop() 之间的耗时和内存分配
+class Timer {
+private:
+    Clock::time_point begin;
+    long long begin_allocs = 0;
+
+public:
+    double seconds = 0;
+    long long allocs = 0;
+
+    void start() {
+        begin_allocs = allocation_count.load(std::memory_order_relaxed);
+        begin = Clock::now();
+    }
+
+    void stop() {
+        seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        allocs += allocation_count.load(std::memory_order_relaxed) - begin_allocs;
+    }
+};
+
+void report(const std::string& name, const Timer& timer, long long ops, const std::string& note = "") {
+    printf("%-52s %12.1f ns/op %10.2f allocs/op  %s\n", name.c_str(), timer.seconds * 1e9 / ops,
+           static_cast<double>(timer.allocs) / ops, note.c_str());
+}
+
+// 随机的标签预测信息，每个标签每个 epoch 的删除、写入、读取块数
+std::vector<std::vector<std::vector<int>>> make_tag_info(std::mt19937& rng) {
+    int n_epoch = (T - 1) / FRE_PER_SLICING + 1;
+    std::vector<std::vector<std::vector<int>>> tag_info(M + 1, std::vector<std::vector<int>>(n_epoch + 1, std::vector<int>(3)));
+    for (int tag = 1; tag <= M; tag++) {
+        for (int e = 1; e <= n_epoch; e++) {
+            tag_info[tag][e][1] = 1000 + static_cast<int>(rng() % 1000);
+            tag_info[tag][e][0] = static_cast<int>(rng() % 1000);
+            tag_info[tag][e][2] = static_cast<int>(rng() % 5000);
+        }
+    }
+    return tag_info;
+}
+
+// N 个磁盘、写满 fill 比例的调度器，返回写入的对象id
+struct SchedulerFixture {
+    std::mt19937 rng;
+    std::vector<std::vector<std::vector<int>>> tag_info;
+    DiskScheduler scheduler;
+    std::vector<int> live_objects;
+    int next_object = 1;
+    int next_request = 1;
+    int timestamp = 1;
+
+    SchedulerFixture(int N, int G, double fill)
+        : rng(12345), tag_info(make_tag_info(rng)),
+          scheduler(M, N, V, G, tag_info, std::vector<std::vector<float>>(M + 1, std::vector<float>(tag_info[1].size())))
+    {
+        scheduler.update_tag_heat(1);
+        long long target = static_cast<long long>(fill * N * V / REP_NUM);
+        long long used = 0;
+        while (used < target) {
+            used += write_random();
+        }
+    }
+
+    int write_random() {
+        Object obj(next_object++, 1 + static_cast<int>(rng() % MAX_OBJ_SIZE), 1 + static_cast<int>(rng() % M));
+        scheduler.write_object(obj);
+        live_objects.emplace_back(obj.id);
+        return obj.size;
+    }
+
+    int random_object() {
+        return live_objects[rng() % live_objects.size()];
+    }
+};
+
+// 分配和释放交替进行：先写到 fill 比例，之后每次操作释放一个随机对象再分配一个随机大小的对象
+template <typename Manager>
+void bench_alloc(const char* manager_name, double fill) {
+    std::mt19937 rng(1);
+    Manager manager(V);
+    std::vector<std::vector<int>> live;
+    int used = 0;
+    // 放在堆上：std::sort 内联进来后，GCC 会按排序的阈值对定长数组误报 -Warray-bounds
+    std::vector<int> units_buffer(MAX_OBJ_SIZE + 1);
+    int* units = units_buffer.data();
+    while (used < fill * V) {
+        int size = 1 + static_cast<int>(rng() % MAX_OBJ_SIZE);
+        if (!manager.allocate(size, units))
+            break;
+        live.emplace_back(units, units + size + 1);
+        used += size;
+    }
+    // 预先生成随机序列，计时区间内只有分配和释放
+    const int OPS = 200000;
+    std::vector<int> victims(OPS), sizes(OPS);
+    for (int i = 0; i < OPS; i++) {
+        victims[i] = static_cast<int>(rng() % live.size());
+        sizes[i] = 1 + static_cast<int>(rng() % MAX_OBJ_SIZE);
+    }
+
+    Timer timer;
+    int failed = 0;
+    for (int i = 0; i < OPS; i++) {
+        std::vector<int>& victim = live[victims[i]];
+        timer.start();
+        manager.freeBlock(victim.data(), static_cast<int>(victim.size()) - 1);
+        bool ok = manager.allocate(sizes[i], units);
+        timer.stop();
+        if (!ok) {
+            failed++;
+            manager.allocate(static_cast<int>(victim.size()) - 1, victim.data());
+            continue;
+        }
+        victim.assign(units, units + sizes[i] + 1);
+    }
+    char name[64], note[64];
+    snprintf(name, sizeof(name), "alloc_churn/%s/fill=%.2f", manager_name, fill);
+    snprintf(note, sizeof(note), "failed=%d", failed);
+    report(name, timer, OPS, note);
+}
+
+// 每轮用 write_objects 写入 batch 个随机对象（与判题时的写入路径相同），再删除同样多的随机对象保持占用率
+// 计时区间只包含 write_objects，按对象计算
+void bench_write_objects(int N, double fill, int batch) {
+    SchedulerFixture fixture(N, 1000, fill);
+    const int ROUNDS = 20000 / batch;
+    Timer timer;
+    long long checksum = 0;
+    std::vector<Object> objects;
+    std::vector<int> victims;
+    for (int round = 0; round < ROUNDS; round++) {
+        objects.clear();
+        for (int i = 0; i < batch; i++) {
+            objects.emplace_back(fixture.next_object++, 1 + static_cast<int>(fixture.rng() % MAX_OBJ_SIZE), 1 + static_cast<int>(fixture.rng() % M));
+        }
+        timer.start();
+        fixture.scheduler.write_objects(objects);
+        timer.stop();
+        victims.clear();
+        for (const Object& obj : objects) {
+            checksum += obj.replicas[0].disk_id;
+            int k = static_cast<int>(fixture.rng() % fixture.live_objects.size());
+            victims.emplace_back(fixture.live_objects[k]);
+            fixture.live_objects[k] = obj.id;
+        }
+        fixture.scheduler.delete_objects(victims);
+    }
+    char name[64], note[64];
+    snprintf(name, sizeof(name), "write_objects/N=%d/fill=%.2f/batch=%d", N, fill, batch);
+    snprintf(note, sizeof(note), "checksum=%lld", checksum);
+    report(name, timer, static_cast<long long>(ROUNDS) * batch, note);
+}
+
+// 每个被删除的对象有 pending 个还没完成的请求，计时区间只包含 delete_objects
+void bench_delete(int pending) {
+    SchedulerFixture fixture(10, 1000, 0.5);
+    const int ROUNDS = 50;
+    const int BATCH = 200;
+    Timer timer;
+    long long aborted = 0;
+    std::vector<int> batch;
+    for (int round = 0; round < ROUNDS; round++) {
+        batch.clear();
+        for (int i = 0; i < BATCH; i++) {
+            int k = static_cast<int>(fixture.rng() % fixture.live_objects.size());
+            int object_id = fixture.live_objects[k];
+            fixture.live_objects[k] = fixture.live_objects.back();
+            fixture.live_objects.pop_back();
+            batch.emplace_back(object_id);
+            for (int r = 0; r < pending; r++) {
+                fixture.scheduler.add_request(fixture.next_request++, object_id, fixture.timestamp);
+            }
+        }
+        // 让一部分请求分配到磁盘上，删除时需要从待读集合中移除
+        fixture.scheduler.age_requests(fixture.timestamp);
+        std::vector<std::string> actions(11);
+        std::vector<int> completed;
+        fixture.scheduler.read_one_timeslice(actions, completed);
+        fixture.timestamp++;
+
+        timer.start();
+        aborted += fixture.scheduler.delete_objects(batch).size();
+        timer.stop();
+        for (int i = 0; i < BATCH; i++) {
+            fixture.write_random();
+        }
+    }
+    char name[64], note[64];
+    snprintf(name, sizeof(name), "delete_object/pending=%d", pending);
+    snprintf(note, sizeof(note), "aborted/op=%.1f", static_cast<double>(aborted) / (ROUNDS * BATCH));
+    report(name, timer, ROUNDS * BATCH, note);
+}
+
+// 每个时间片到达 arrivals 个读请求，稳定后测量 read_one_timeslice，队列深度由到达速度决定
+void bench_read_slice(int arrivals) {
+    const int N = 10;
+    SchedulerFixture fixture(N, 1000, 0.5);
+    std::vector<std::string> actions(N + 1);
+    std::vector<int> completed;
+    const int WARMUP = EXTRA_TIME + 20;
+    const int SLICES = 400;
+    Timer timer;
+    long long completed_count = 0;
+    for (int s = 0; s < WARMUP + SLICES; s++) {
+        int t = fixture.timestamp++;
+        fixture.scheduler.age_requests(t);
+        for (int i = 0; i < arrivals; i++) {
+            fixture.scheduler.add_request(fixture.next_request++, fixture.random_object(), t);
+        }
+        completed.clear();
+        if (s >= WARMUP)
+            timer.start();
+        fixture.scheduler.read_one_timeslice(actions, completed);
+        if (s >= WARMUP) {
+            timer.stop();
+            completed_count += completed.size();
+        }
+    }
+    char name[64], note[64];
+    snprintf(name, sizeof(name), "read_one_timeslice/arrivals=%d", arrivals);
+    snprintf(note, sizeof(note), "completed/slice=%.1f", static_cast<double>(completed_count) / SLICES);
+    report(name, timer, SLICES, note);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string filter = argc >= 2 ? argv[1] : "";
+    auto selected = [&](const char* name) { return filter.empty() || strstr(name, filter.c_str()) != nullptr; };
+
+    if (selected("alloc_churn")) {
+        for (double fill : {0.5, 0.9}) {
+            bench_alloc<ExtentFreeList>("ExtentFreeList", fill);
+            bench_alloc<BasicExtentFreeList<BestFit>>("ExtentFreeList<BestFit>", fill);
+            bench_alloc<SegregatedFreeList>("SegregatedFreeList", fill);
+            bench_alloc<BasicSegregatedFreeList<BestFit>>("SegregatedFreeList<BestFit>", fill);
+        }
+    }
+    if (selected("write_objects")) {
+        for (double fill : {0.3, 0.85}) {
+            for (int batch : {1, 20}) {
+                bench_write_objects(10, fill, batch);
+            }
+        }
+    }
+    if (selected("delete_object")) {
+        for (int pending : {0, 4, 32}) {
+            bench_delete(pending);
+        }
+    }
+    if (selected("read_one_timeslice")) {
+        for (int arrivals : {10, 100, 1000}) {
+            bench_read_slice(arrivals);
+        }
+    }
+    return 0;
+}
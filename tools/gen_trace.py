@@ -0,0 +1,116 @@
+# -*- coding: utf-8 -*-
+# 生成 data/sample.in 格式的随机数据，配合 simulator 在本地评测
+# 每个标签的读取热度随时间按正弦规律变化（相位各不相同），写入/删除使磁盘占用维持在 fill 附近
+import argparse
+import math
+import random
+
+FRE_PER_SLICING = 1800
+EXTRA_TIME = 105
+# 任务书限制整个数据中写入和删除的对象总数都不超过 10^5，对象id从 1 开始连续编号
+MAX_WRITES = 100000
+MAX_DELETES = 100000
+
+
+def main(args):
+    rnd = random.Random(args.seed)
+    T, M, N, V, G = args.T, args.M, args.N, args.V, args.G
+    n_epoch = (T - 1) // FRE_PER_SLICING + 1
+    fre = [[[0] * n_epoch for _ in range(M)] for _ in range(3)]  # fre[删/写/读][tag][epoch]
+
+    # 三副本，存储单元总数为 N*V，占用超过 fill 之后只删不写
+    capacity = N * V // 3
+    used = 0
+    live = [[] for _ in range(M)]   # 每个标签当前存活的对象id
+    where = {}                      # object_id -> (tag, 在 live[tag] 中的下标)
+    size_of = {}
+    phase = [rnd.uniform(0, 2 * math.pi) for _ in range(M)]
+    next_object, next_request = 1, 1
+    n_deleted = 0
+    slices = []
+
+    def remove(object_id):
+        tag, idx = where.pop(object_id)
+        last = live[tag][-1]
+        live[tag][idx] = last
+        where[last] = (tag, idx)
+        live[tag].pop()
+
+    for t in range(1, T + EXTRA_TIME + 1):
+        epoch = (t - 1) // FRE_PER_SLICING
+        out = ["TIMESTAMP %d" % t]
+        deletes, writes, reads = [], [], []
+        if t <= T:
+            # 删除
+            n_delete = sum(1 for _ in range(args.delete_rate * 2) if rnd.random() < 0.5)
+            if used > capacity * args.fill:
+                n_delete *= 2
+            for _ in range(n_delete):
+                if n_deleted >= MAX_DELETES:
+                    break
+                tag = rnd.randrange(M)
+                if not live[tag]:
+                    continue
+                object_id = live[tag][rnd.randrange(len(live[tag]))]
+                remove(object_id)
+                used -= size_of[object_id]
+                fre[0][tag][epoch] += size_of[object_id]
+                deletes.append(object_id)
+                n_deleted += 1
+            # 写入
+            if used < capacity * args.fill:
+                for _ in range(sum(1 for _ in range(args.write_rate * 2) if rnd.random() < 0.5)):
+                    tag = rnd.randrange(M)
+                    size = rnd.randint(1, 5)
+                    if used + size > capacity * 0.9 or next_object > MAX_WRITES:
+                        break
+                    object_id = next_object
+                    next_object += 1
+                    where[object_id] = (tag, len(live[tag]))
+                    live[tag].append(object_id)
+                    size_of[object_id] = size
+                    used += size
+                    fre[1][tag][epoch] += size
+                    writes.append("%d %d %d" % (object_id, size, tag + 1))
+            # 读取，标签热度随时间变化
+            heat = [1.0 + math.sin(2 * math.pi * t / args.period + phase[tag]) for tag in range(M)]
+            total_heat = sum(heat)
+            for _ in range(sum(1 for _ in range(args.read_rate * 2) if rnd.random() < 0.5)):
+                tag = rnd.choices(range(M), heat)[0] if total_heat > 0 else rnd.randrange(M)
+                if not live[tag]:
+                    continue
+                object_id = live[tag][rnd.randrange(len(live[tag]))]
+                fre[2][tag][epoch] += size_of[object_id]
+                reads.append("%d %d" % (next_request, object_id))
+                next_request += 1
+        out.append(str(len(deletes)))
+        out.extend(map(str, deletes))
+        out.append(str(len(writes)))
+        out.extend(writes)
+        out.append(str(len(reads)))
+        out.extend(reads)
+        slices.append("\n".join(out))
+
+    with open(args.output, "w") as f:
+        f.write("%d %d %d %d %d\n" % (T, M, N, V, G))
+        for kind in range(3):
+            for tag in range(M):
+                f.write(" ".join(map(str, fre[kind][tag])) + "\n")
+        f.write("\n".join(slices) + "\n")
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--T', type=int, default=3600)
+    parser.add_argument('--M', type=int, default=8)
+    parser.add_argument('--N', type=int, default=6)
+    parser.add_argument('--V', type=int, default=4096)
+    parser.add_argument('--G', type=int, default=350)
+    parser.add_argument('--write-rate', type=int, default=8, help='每个时间片平均写入对象数')
+    parser.add_argument('--delete-rate', type=int, default=6, help='每个时间片平均删除对象数')
+    parser.add_argument('--read-rate', type=int, default=20, help='每个时间片平均读请求数')
+    parser.add_argument('--fill', type=float, default=0.7, help='目标磁盘占用率')
+    parser.add_argument('--period', type=int, default=3600, help='标签热度变化周期（时间片）')
+    parser.add_argument('--seed', type=int, default=2025)
+    parser.add_argument('--output', '-o', type=str, default='data/gen.in')
+    main(parser.parse_args())
@@ -0,0 +1,139 @@
+// 回放 code_craft 在 RECORD_FILE 模式下记录的二进制输入（格式见 TraceFile.hpp），
+// 用 mmap 读取，直接按 main.cpp 的顺序调用 DiskScheduler，不经过文本协议和判题器，结果完全可重复，适合单独分析调度器的耗时。
+//
+// 用法：RECORD_FILE=/tmp/run.bin ./simulator data/sample.in ./code_craft    # 记录
+//      ./replay /tmp/run.bin [线程数]                                       # 回放
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "DiskScheduler.hpp"
+#include "TraceFile.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum Phase { PHASE_DELETE, PHASE_WRITE, PHASE_READ, PHASE_NUM };
+const char* PHASE_NAMES[PHASE_NUM] = {"delete", "write", "read"};
+
+struct ReplayStats {
+    long long requests = 0;
+    long long completed = 0;
+    long long aborted = 0;
+    long long expired = 0;
+    long long objects_written = 0;
+    long long objects_deleted = 0;
+    double phase_seconds[PHASE_NUM] = {};
+};
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <record file> [threads]\n", argv[0]);
+        return 1;
+    }
+    TraceReplayer trace;
+    if (!trace.open(argv[1])) {
+        fprintf(stderr, "fail to open %s\n", argv[1]);
+        return 1;
+    }
+    int threads = argc >= 3 ? atoi(argv[2]) : READ_THREADS;
+
+    int T = trace.read_int();
+    int M = trace.read_int();
+    int N = trace.read_int();
+    int V = trace.read_int();
+    int G = trace.read_int();
+    int n_epoch = (T - 1) / FRE_PER_SLICING + 1;
+    std::vector<std::vector<std::vector<int>>> tag_info(M + 1, std::vector<std::vector<int>>(n_epoch + 1, std::vector<int>(3)));
+    std::vector<std::vector<float>> tag_heat(M + 1, std::vector<float>(n_epoch + 1));
+    for (int k = 0; k < 3; k++) {
+        for (int i = 1; i <= M; i++) {
+            for (int j = 1; j <= n_epoch; j++) {
+                tag_info[i][j][k] = trace.read_int();
+            }
+        }
+    }
+
+    Clock::time_point run_start = Clock::now();
+    DiskScheduler diskScheduler(M, N, V, G, tag_info, tag_heat);
+    diskScheduler.set_read_threads(threads);
+
+    ReplayStats stats;
+    std::vector<int> delete_object_ids;
+    std::vector<Object> objects;
+    std::vector<std::string> points_action(N + 1);
+    std::vector<int> completed_requests;
+    int t = 1;
+    for (; t <= T + EXTRA_TIME && !trace.finished(); t++) {
+        // 与 main.cpp 的调用顺序相同
+        if ((t - 1) % FRE_PER_SLICING == 0) {
+            diskScheduler.update_tag_heat((t - 1) / FRE_PER_SLICING + 1);
+        }
+        stats.expired += diskScheduler.age_requests(t).size();
+        int timestamp = trace.read_int();
+        if (timestamp != t) {
+            fprintf(stderr, "corrupted record at timestamp %d\n", t);
+            return 1;
+        }
+
+        Clock::time_point start = Clock::now();
+        int n_delete = trace.read_int();
+        const int32_t* ids = trace.read_ints(n_delete);
+        if (ids == nullptr)
+            break;
+        delete_object_ids.assign(ids, ids + n_delete);
+        stats.aborted += diskScheduler.delete_objects(delete_object_ids).size();
+        stats.objects_deleted += n_delete;
+        stats.phase_seconds[PHASE_DELETE] += seconds_since(start);
+
+        start = Clock::now();
+        int n_write = trace.read_int();
+        const int32_t* writes = trace.read_ints(n_write * 3);
+        if (writes == nullptr)
+            break;
+        objects.clear();
+        for (int i = 0; i < n_write; i++) {
+            objects.emplace_back(writes[i * 3], writes[i * 3 + 1], writes[i * 3 + 2]);
+        }
+        diskScheduler.write_objects(objects);
+        stats.objects_written += n_write;
+        stats.phase_seconds[PHASE_WRITE] += seconds_since(start);
+
+        start = Clock::now();
+        int n_read = trace.read_int();
+        const int32_t* reads = trace.read_ints(n_read * 2);
+        if (reads == nullptr)
+            break;
+        for (int i = 0; i < n_read; i++) {
+            diskScheduler.add_request(reads[i * 2], reads[i * 2 + 1], t);
+        }
+        completed_requests.clear();
+        diskScheduler.read_one_timeslice(points_action, completed_requests);
+        stats.requests += n_read;
+        stats.completed += completed_requests.size();
+        stats.phase_seconds[PHASE_READ] += seconds_since(start);
+    }
+    double total = seconds_since(run_start);
+
+    printf("slices           %d\n", t - 1);
+    printf("requests         %lld\n", stats.requests);
+    printf("  completed      %lld\n", stats.completed);
+    printf("  aborted        %lld\n", stats.aborted);
+    printf("  expired        %lld\n", stats.expired);
+    printf("objects written  %lld\n", stats.objects_written);
+    printf("objects deleted  %lld\n", stats.objects_deleted);
+    for (int p = 0; p < PHASE_NUM; p++) {
+        printf("time %-11s %.3fs\n", PHASE_NAMES[p], stats.phase_seconds[p]);
+    }
+    printf("time total       %.3fs\n", total);
+    return 0;
+}
@@ -0,0 +1,518 @@
+// 本地判题器/模拟器：读取 data/sample.in 格式的数据，通过管道驱动选手程序（code_craft），
+// 校验每个阶段的输出并按照任务书的规则计分，用于在没有官方 interactor 的机器上评测调度算法。
+//
+// 用法：./simulator <数据文件> <选手程序命令>
+// 例如：./simulator data/sample.in ./code_craft
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../limit.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum Phase { PHASE_PRELUDE, PHASE_TIMESTAMP, PHASE_DELETE, PHASE_WRITE, PHASE_READ, PHASE_NUM };
+const char* PHASE_NAMES[PHASE_NUM] = {"prelude", "timestamp", "delete", "write", "read"};
+
+// 任务书对整个数据的限制：写入和删除的对象总数都不超过 10^5，对象id和请求id不超过选手程序的数组大小
+const int MAX_WRITE_TOTAL = MAX_OBJECT_NUM - 1;
+const int MAX_DELETE_TOTAL = 100000;
+
+enum class ReqState : unsigned char {
+    PENDING,    // 还没上报
+    COMPLETED,  // 已上报完成
+    ABORTED     // 因对象被删除而取消
+};
+
+struct SimObject {
+    int size = 0;
+    int tag = 0;
+    bool alive = false;
+    int disk[REP_NUM] = {};
+    int units[REP_NUM][MAX_OBJ_SIZE + 1] = {};
+    std::vector<int> pending;   // 该对象还没上报的请求id，惰性清理
+};
+
+struct SimRequest {
+    int object_id;
+    int arrive_timestamp;
+    unsigned char read_mask;    // 第 i 位表示第 i+1 个对象块在请求到达后已被读取过
+    ReqState state;
+};
+
+struct Head {
+    int pos = 1;
+    bool last_action_is_read = false;
+    int last_token_cost = 0;
+};
+
+struct Stats {
+    double score = 0;
+    long long requests = 0;
+    long long completed = 0;        // 在 EXTRA_TIME 窗口内完成并得分的请求
+    long long completed_late = 0;   // 完成但超过 EXTRA_TIME，记0分
+    long long aborted = 0;
+    long long expired = 0;          // 交互结束时仍未上报
+    long long objects_written = 0;
+    long long objects_deleted = 0;
+    double phase_seconds[PHASE_NUM] = {};
+};
+
+class Simulator {
+public:
+    Simulator(FILE* trace, FILE* to_player, FILE* from_player, pid_t player_pid)
+        : trace(trace), to_player(to_player), from_player(from_player), player_pid(player_pid) {}
+
+    int run() {
+        run_prelude();
+        for (timestamp = 1; timestamp <= T + EXTRA_TIME; timestamp++) {
+            run_timestamp();
+            run_delete();
+            run_write();
+            run_read();
+        }
+        for (size_t i = 1; i < requests.size(); i++) {
+            if (requests[i].state == ReqState::PENDING)
+                stats.expired++;
+        }
+        report();
+        return 0;
+    }
+
+private:
+    FILE* trace;
+    FILE* to_player;
+    FILE* from_player;
+    pid_t player_pid;
+
+    int T = 0, M = 0, N = 0, V = 0, G = 0;
+    int timestamp = 0;
+    long long used_units = 0;
+    int total_written = 0;  // 数据中到目前为止写入/删除的对象数，用来检查总数限制
+    int total_deleted = 0;
+
+    std::vector<SimObject> objects;     // 下标为对象id
+    std::vector<SimRequest> requests;   // 下标为请求id
+    std::vector<std::vector<int>> unit_object;  // unit_object[disk][unit]，0 表示空闲
+    std::vector<std::vector<unsigned char>> unit_block;  // 该存储单元存放的是对象的第几块
+    std::vector<Head> heads;
+    Stats stats;
+
+    // 遇到选手程序输出不合法或数据不合法时直接终止
+    [[noreturn]] void fail(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        fprintf(stderr, "[simulator] error at timestamp %d: ", timestamp);
+        vfprintf(stderr, fmt, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+        kill(player_pid, SIGKILL);
+        waitpid(player_pid, nullptr, 0);
+        exit(1);
+    }
+
+    int read_trace_int() {
+        int x;
+        if (fscanf(trace, "%d", &x) != 1)
+            fail("unexpected end of trace");
+        return x;
+    }
+
+    int read_player_int() {
+        int x;
+        if (fscanf(from_player, "%d", &x) != 1)
+            fail("player output ended or is not an integer");
+        return x;
+    }
+
+    void flush_to_player() {
+        if (fflush(to_player) != 0)
+            fail("player closed its input");
+    }
+
+    void add_phase_time(Phase phase, Clock::time_point start) {
+        stats.phase_seconds[phase] += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void run_prelude() {
+        if (fscanf(trace, "%d%d%d%d%d", &T, &M, &N, &V, &G) != 5)
+            fail("bad trace header");
+        if (T < 1 || M < 1 || N < REP_NUM || N > MAX_DISK_NUM - 1 || V < 1 || V > MAX_DISK_SIZE - 1 || G < 1)
+            fail("trace header %d %d %d %d %d is out of the spec limits", T, M, N, V, G);
+        int n_epoch = (T - 1) / FRE_PER_SLICING + 1;
+
+        auto start = Clock::now();
+        fprintf(to_player, "%d %d %d %d %d\n", T, M, N, V, G);
+        // 删除、写入、读取三组，每组 M 行，每行 n_epoch 个数
+        for (int i = 0; i < 3 * M; i++) {
+            for (int j = 0; j < n_epoch; j++) {
+                fprintf(to_player, j == 0 ? "%d" : " %d", read_trace_int());
+            }
+            fprintf(to_player, "\n");
+        }
+        flush_to_player();
+
+        char token[16];
+        if (fscanf(from_player, "%15s", token) != 1 || strcmp(token, "OK") != 0)
+            fail("expected OK after prelude");
+        add_phase_time(PHASE_PRELUDE, start);
+
+        objects.resize(1);
+        requests.resize(1);
+        unit_object.assign(N + 1, std::vector<int>(V + 1, 0));
+        unit_block.assign(N + 1, std::vector<unsigned char>(V + 1, 0));
+        heads.assign(N + 1, Head());
+    }
+
+    void run_timestamp() {
+        char token[16];
+        int t;
+        if (fscanf(trace, "%15s%d", token, &t) != 2 || strcmp(token, "TIMESTAMP") != 0 || t != timestamp)
+            fail("trace is missing TIMESTAMP %d", timestamp);
+
+        auto start = Clock::now();
+        fprintf(to_player, "TIMESTAMP %d\n", timestamp);
+        flush_to_player();
+        if (fscanf(from_player, "%15s%d", token, &t) != 2 || strcmp(token, "TIMESTAMP") != 0 || t != timestamp)
+            fail("player did not echo TIMESTAMP %d", timestamp);
+        add_phase_time(PHASE_TIMESTAMP, start);
+    }
+
+    void run_delete() {
+        int n_delete = read_trace_int();
+        if (n_delete < 0 || n_delete > MAX_DELETE_TOTAL - total_deleted)
+            fail("trace deletes %d objects, more than the %d allowed in total", n_delete, MAX_DELETE_TOTAL);
+        total_deleted += n_delete;
+        std::vector<int> ids(n_delete);
+        for (int i = 0; i < n_delete; i++) {
+            ids[i] = read_trace_int();
+            if (ids[i] <= 0 || ids[i] >= (int)objects.size() || !objects[ids[i]].alive)
+                fail("trace deletes object %d which is not stored", ids[i]);
+        }
+
+        auto start = Clock::now();
+        fprintf(to_player, "%d\n", n_delete);
+        for (int id : ids)
+            fprintf(to_player, "%d\n", id);
+        flush_to_player();
+
+        // 被删除对象所有未上报的请求都必须被取消，且只能被取消一次
+        std::vector<int> expected;
+        for (int id : ids) {
+            for (int req_id : objects[id].pending) {
+                if (requests[req_id].state == ReqState::PENDING)
+                    expected.emplace_back(req_id);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        int n_abort = read_player_int();
+        std::vector<int> aborted(n_abort);
+        for (int i = 0; i < n_abort; i++)
+            aborted[i] = read_player_int();
+        add_phase_time(PHASE_DELETE, start);
+
+        std::sort(aborted.begin(), aborted.end());
+        if (aborted != expected)
+            fail("aborted requests mismatch: player reported %d, expected %d", n_abort, (int)expected.size());
+        for (int req_id : aborted) {
+            requests[req_id].state = ReqState::ABORTED;
+            stats.aborted++;
+        }
+
+        for (int id : ids) {
+            SimObject& obj = objects[id];
+            for (int r = 0; r < REP_NUM; r++) {
+                for (int b = 1; b <= obj.size; b++) {
+                    unit_object[obj.disk[r]][obj.units[r][b]] = 0;
+                }
+            }
+            used_units -= (long long)REP_NUM * obj.size;
+            obj.alive = false;
+            obj.pending.clear();
+            obj.pending.shrink_to_fit();
+            stats.objects_deleted++;
+        }
+    }
+
+    void run_write() {
+        int n_write = read_trace_int();
+        if (n_write < 0 || n_write > MAX_WRITE_TOTAL - total_written)
+            fail("trace writes %d objects, more than the %d allowed in total", n_write, MAX_WRITE_TOTAL);
+        total_written += n_write;
+        std::vector<int> ids(n_write);
+        std::string input = std::to_string(n_write) + "\n";
+        for (int i = 0; i < n_write; i++) {
+            int id = read_trace_int(), size = read_trace_int(), tag = read_trace_int();
+            if (size < 1 || size > MAX_OBJ_SIZE || tag < 1 || tag > M)
+                fail("trace writes object %d with bad size %d or tag %d", id, size, tag);
+            if (id < 1 || id > MAX_OBJECT_NUM - 1)
+                fail("trace writes object %d, ids must be in [1, %d]", id, MAX_OBJECT_NUM - 1);
+            if (id < (int)objects.size() && objects[id].size != 0)
+                fail("trace writes object %d more than once", id);
+            if (id >= (int)objects.size())
+                objects.resize(id + 1);
+            objects[id].size = size;
+            objects[id].tag = tag;
+            ids[i] = id;
+            input += std::to_string(id) + " " + std::to_string(size) + " " + std::to_string(tag) + "\n";
+        }
+
+        auto start = Clock::now();
+        fputs(input.c_str(), to_player);
+        flush_to_player();
+
+        // 写入顺序不需要和输入一致，但每个对象都要恰好写一次
+        std::vector<int> written;
+        written.reserve(n_write);
+        for (int i = 0; i < n_write; i++) {
+            int id = read_player_int();
+            if (id <= 0 || id >= (int)objects.size() || objects[id].size == 0 || objects[id].alive)
+                fail("player wrote unexpected object %d", id);
+            SimObject& obj = objects[id];
+            for (int r = 0; r < REP_NUM; r++) {
+                int disk_id = read_player_int();
+                if (disk_id < 1 || disk_id > N)
+                    fail("object %d replica %d on bad disk %d", id, r + 1, disk_id);
+                for (int k = 0; k < r; k++) {
+                    if (obj.disk[k] == disk_id)
+                        fail("object %d has two replicas on disk %d", id, disk_id);
+                }
+                obj.disk[r] = disk_id;
+                for (int b = 1; b <= obj.size; b++) {
+                    int unit = read_player_int();
+                    if (unit < 1 || unit > V)
+                        fail("object %d replica %d uses bad unit %d", id, r + 1, unit);
+                    if (unit_object[disk_id][unit] != 0)
+                        fail("object %d overwrites unit %d on disk %d", id, unit, disk_id);
+                    unit_object[disk_id][unit] = id;
+                    unit_block[disk_id][unit] = (unsigned char)b;
+                    obj.units[r][b] = unit;
+                }
+            }
+            obj.alive = true;
+            used_units += (long long)REP_NUM * obj.size;
+            written.emplace_back(id);
+        }
+        add_phase_time(PHASE_WRITE, start);
+
+        std::sort(written.begin(), written.end());
+        std::sort(ids.begin(), ids.end());
+        if (written != ids)
+            fail("player did not write exactly the requested objects");
+        stats.objects_written += n_write;
+
+        // 数据保证任何时候至少有 10% 的存储单元空闲
+        if (used_units * 10 > 9LL * N * V)
+            fail("trace violates the 10%% free space rule (%lld of %lld units used)", used_units, (long long)N * V);
+    }
+
+    // 读取 disk 上 unit 处的对象块，给该对象所有等待中的请求记上这一块
+    void on_unit_read(int disk_id, int unit) {
+        int object_id = unit_object[disk_id][unit];
+        if (object_id == 0)
+            return;
+        unsigned char bit = (unsigned char)(1u << (unit_block[disk_id][unit] - 1));
+        std::vector<int>& pending = objects[object_id].pending;
+        for (size_t i = 0; i < pending.size();) {
+            SimRequest& req = requests[pending[i]];
+            if (req.state != ReqState::PENDING) {
+                pending[i] = pending.back();
+                pending.pop_back();
+                continue;
+            }
+            req.read_mask |= bit;
+            i++;
+        }
+    }
+
+    void run_head(int disk_id, const char* action) {
+        Head& head = heads[disk_id];
+        if (action[0] == 'j') {
+            int target = read_player_int();
+            if (target < 1 || target > V)
+                fail("disk %d jumps to bad unit %d", disk_id, target);
+            head.pos = target;
+            head.last_action_is_read = false;
+            head.last_token_cost = G;
+            return;
+        }
+
+        int tokens = G;
+        size_t len = strlen(action);
+        if (len == 0 || action[len - 1] != '#')
+            fail("disk %d action \"%s\" does not end with #", disk_id, action);
+        for (size_t k = 0; k + 1 < len; k++) {
+            int cost;
+            if (action[k] == 'p') {
+                cost = 1;
+            }
+            else if (action[k] == 'r') {
+                cost = head.last_action_is_read
+                    ? std::max(16, (int)std::ceil(head.last_token_cost * 0.8))
+                    : 64;
+            }
+            else {
+                fail("disk %d has bad action character '%c'", disk_id, action[k]);
+            }
+            tokens -= cost;
+            if (tokens < 0)
+                fail("disk %d spends more than G=%d tokens", disk_id, G);
+            if (action[k] == 'r')
+                on_unit_read(disk_id, head.pos);
+            head.last_action_is_read = action[k] == 'r';
+            head.last_token_cost = cost;
+            head.pos = head.pos % V + 1;
+        }
+    }
+
+    static double score_of(int delay, int size) {
+        double f;
+        if (delay <= 10)
+            f = 1.0 - 0.005 * delay;
+        else if (delay <= EXTRA_TIME)
+            f = 1.05 - 0.01 * delay;
+        else
+            f = 0;
+        return f * (size + 1) * 0.5;
+    }
+
+    void run_read() {
+        int n_read = read_trace_int();
+        if (n_read < 0 || n_read > MAX_REQUEST_NUM - (int)requests.size())
+            fail("trace reads %d objects, request ids would exceed %d", n_read, MAX_REQUEST_NUM - 1);
+        std::string input = std::to_string(n_read) + "\n";
+        for (int i = 0; i < n_read; i++) {
+            int req_id = read_trace_int(), object_id = read_trace_int();
+            if (req_id != (int)requests.size())
+                fail("trace request ids must increase by 1, got %d", req_id);
+            if (object_id <= 0 || object_id >= (int)objects.size() || !objects[object_id].alive)
+                fail("trace reads object %d which is not stored", object_id);
+            requests.push_back({object_id, timestamp, 0, ReqState::PENDING});
+            objects[object_id].pending.emplace_back(req_id);
+            input += std::to_string(req_id) + " " + std::to_string(object_id) + "\n";
+        }
+        stats.requests += n_read;
+
+        auto start = Clock::now();
+        fputs(input.c_str(), to_player);
+        flush_to_player();
+
+        static char action[1 << 16];
+        for (int i = 1; i <= N; i++) {
+            if (fscanf(from_player, "%65535s", action) != 1)
+                fail("player output ended while reading head actions");
+            run_head(i, action);
+        }
+
+        int n_rsp = read_player_int();
+        std::vector<int> completed(n_rsp);
+        for (int i = 0; i < n_rsp; i++)
+            completed[i] = read_player_int();
+        add_phase_time(PHASE_READ, start);
+
+        for (int req_id : completed) {
+            if (req_id <= 0 || req_id >= (int)requests.size())
+                fail("player completed unknown request %d", req_id);
+            SimRequest& req = requests[req_id];
+            if (req.state != ReqState::PENDING)
+                fail("player reported request %d twice", req_id);
+            int size = objects[req.object_id].size;
+            if (req.read_mask != (1u << size) - 1)
+                fail("player completed request %d before all blocks were read", req_id);
+            req.state = ReqState::COMPLETED;
+            int delay = timestamp - req.arrive_timestamp;
+            if (delay > EXTRA_TIME) {
+                stats.completed_late++;
+            }
+            else {
+                stats.completed++;
+                stats.score += score_of(delay, size);
+            }
+        }
+    }
+
+    void report() {
+        printf("score            %.4f\n", stats.score);
+        printf("requests         %lld\n", stats.requests);
+        printf("  completed      %lld\n", stats.completed);
+        printf("  completed late %lld\n", stats.completed_late);
+        printf("  aborted        %lld\n", stats.aborted);
+        printf("  expired        %lld\n", stats.expired);
+        printf("objects written  %lld\n", stats.objects_written);
+        printf("objects deleted  %lld\n", stats.objects_deleted);
+        double total = 0;
+        for (int p = 0; p < PHASE_NUM; p++)
+            total += stats.phase_seconds[p];
+        for (int p = 0; p < PHASE_NUM; p++)
+            printf("time %-11s %.3fs\n", PHASE_NAMES[p], stats.phase_seconds[p]);
+        printf("time total       %.3fs\n", total);
+    }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <trace> <player command>\n", argv[0]);
+        return 2;
+    }
+    FILE* trace = fopen(argv[1], "r");
+    if (trace == nullptr) {
+        perror(argv[1]);
+        return 2;
+    }
+    std::string player = argv[2];
+    for (int i = 3; i < argc; i++)
+        player += std::string(" ") + argv[i];
+
+    // to_player[1] -> 选手 stdin，from_player[0] <- 选手 stdout
+    int to_player[2], from_player[2];
+    if (pipe(to_player) != 0 || pipe(from_player) != 0) {
+        perror("pipe");
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        dup2(to_player[0], STDIN_FILENO);
+        dup2(from_player[1], STDOUT_FILENO);
+        close(to_player[0]);
+        close(to_player[1]);
+        close(from_player[0]);
+        close(from_player[1]);
+        execl("/bin/sh", "sh", "-c", player.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    close(to_player[0]);
+    close(from_player[1]);
+
+    FILE* out = fdopen(to_player[1], "w");
+    FILE* in = fdopen(from_player[0], "r");
+    Simulator simulator(trace, out, in, pid);
+    int ret = simulator.run();
+
+    fclose(out);
+    fclose(in);
+    waitpid(pid, nullptr, 0);
+    fclose(trace);
+    return ret;
+}
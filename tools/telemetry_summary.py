@@ -0,0 +1,76 @@
+# -*- coding: utf-8 -*-
+# 汇总 ENABLE_TELEMETRY 版本的 code_craft 输出的二进制统计（格式见 Telemetry.hpp）
+# 用法：TELEMETRY_FILE=/tmp/run.tm ./simulator data/sample.in ./code_craft && python3 tools/telemetry_summary.py /tmp/run.tm
+import argparse
+import struct
+
+HEADER = struct.Struct('<4siii')
+SLICE = struct.Struct('<8i')
+DISK = struct.Struct('<4H3i')
+EXTRA_TIME = 105
+
+
+def percentile(hist, total, q):
+    target = total * q
+    seen = 0
+    for latency, count in enumerate(hist):
+        seen += count
+        if seen >= target:
+            return latency
+    return len(hist) - 1
+
+
+def main(args):
+    with open(args.trace, 'rb') as f:
+        data = f.read()
+    magic, version, num_disks, G = HEADER.unpack_from(data, 0)
+    if magic != b'CCTM':
+        raise SystemExit('not a telemetry file')
+    pos = HEADER.size
+
+    slices = 0
+    totals = [0] * 6   # 到达、开始、完成、取消、超时、积压请求数之和
+    max_backlog = 0
+    tokens = [[0] * 4 for _ in range(num_disks + 1)]  # pass, read, jump, idle
+    last_disks = [None] * (num_disks + 1)
+    max_runs = [0] * (num_disks + 1)
+    hist = [0] * (EXTRA_TIME + 1)
+    while pos + SLICE.size <= len(data):
+        _, arrived, started, completed, aborted, expired, backlog, latency_count = SLICE.unpack_from(data, pos)
+        pos += SLICE.size
+        slices += 1
+        for i, v in enumerate((arrived, started, completed, aborted, expired, backlog)):
+            totals[i] += v
+        max_backlog = max(max_backlog, backlog)
+        for d in range(1, num_disks + 1):
+            record = DISK.unpack_from(data, pos)
+            pos += DISK.size
+            for k in range(4):
+                tokens[d][k] += record[k]
+            last_disks[d] = record
+            max_runs[d] = max(max_runs[d], record[6])
+        for latency in data[pos:pos + latency_count]:
+            hist[min(latency, EXTRA_TIME)] += 1
+        pos += latency_count
+
+    print('slices          %d (N=%d, G=%d)' % (slices, num_disks, G))
+    print('requests        arrived %d, started %d, completed %d, aborted %d, expired %d' % tuple(totals[:5]))
+    print('backlog         avg %.1f, max %d' % (totals[5] / max(slices, 1), max_backlog))
+    done = sum(hist)
+    if done:
+        mean = sum(latency * count for latency, count in enumerate(hist)) / done
+        print('latency         mean %.1f, p50 %d, p90 %d, p99 %d, max %d' % (
+            mean, percentile(hist, done, 0.5), percentile(hist, done, 0.9), percentile(hist, done, 0.99),
+            max(latency for latency, count in enumerate(hist) if count)))
+    print('disk  pass%  read%  jump%  idle%  pending  free  free_runs(max)')
+    budget = max(slices * G, 1)
+    for d in range(1, num_disks + 1):
+        p, r, j, i = (100.0 * t / budget for t in tokens[d])
+        last = last_disks[d] or (0,) * 7
+        print('%4d %6.1f %6.1f %6.1f %6.1f %8d %5d %5d(%d)' % (d, p, r, j, i, last[4], last[5], last[6], max_runs[d]))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('trace', help='TELEMETRY_FILE 输出的文件')
+    main(parser.parse_args())